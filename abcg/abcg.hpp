@@ -16,6 +16,9 @@
 #include "abcgApplication.hpp"
 #include "abcgException.hpp"
 #include "abcgExternal.hpp"
+#include "abcgFileWatcher.hpp"
+#include "abcgProfiler.hpp"
+#include "abcgShaderSourceCache.hpp"
 #include "abcgTrackball.hpp"
 #include "abcgUtil.hpp"
 #include "abcgWindow.hpp"
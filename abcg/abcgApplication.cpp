@@ -66,8 +66,13 @@ abcg::Application::Application([[maybe_unused]] int argc, char **argv) {
 /**
  * @brief Runs the application for the given window.
  *
- * Initializes the SDL library and its subsystems, initializes the window and
- * runs the event loop.
+ * Initializes the SDL library and its subsystems, starts the job system,
+ * initializes the window and runs the event loop.
+ *
+ * In headless mode (see abcg::WindowSettings::headless), the SDL video,
+ * audio and game controller subsystems are not initialized, and the window is
+ * repainted until abcg::WindowSettings::headlessFrames frames are rendered or
+ * abcg::WindowSettings::headlessDuration seconds have passed.
  *
  * @param window L-value reference to the window object.
  *
@@ -75,8 +80,10 @@ abcg::Application::Application([[maybe_unused]] int argc, char **argv) {
  * @throw abcg::SDLImageError if `IMG_Init` failed.
  */
 void abcg::Application::run(Window &window) {
-  if (Uint32 const subsystemMask{SDL_INIT_VIDEO | SDL_INIT_AUDIO |
-                                 SDL_INIT_GAMECONTROLLER};
+  auto const headless{window.getWindowSettings().headless};
+  if (Uint32 const subsystemMask{
+          headless ? 0U
+                   : SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_GAMECONTROLLER};
       SDL_Init(subsystemMask) != 0) {
     throw abcg::SDLError("SDL_Init failed");
   }
@@ -90,20 +97,33 @@ void abcg::Application::run(Window &window) {
   }
 #endif
 
+#if defined(__EMSCRIPTEN__)
+  // Jobs run only on the thread that waits for them
+  m_jobSystem = std::make_unique<JobSystem>(0);
+#else
+  m_jobSystem = std::make_unique<JobSystem>(JobSystem::getDefaultNumWorkers());
+#endif
+
   m_window = &window;
   m_window->templateCreate();
 
 #if defined(__EMSCRIPTEN__)
   emscripten_set_main_loop_arg(mainLoopCallback, this, 0, true);
 #else
-  auto done{false};
-  while (!done) {
-    mainLoopIterator(done);
+  if (headless) {
+    headlessLoop();
+  } else {
+    auto done{false};
+    while (!done) {
+      mainLoopIterator(done);
+    }
   }
 #endif
 
   m_window->templateDestroy();
 
+  m_jobSystem.reset();
+
 #if !defined(__EMSCRIPTEN__)
   IMG_Quit();
 #endif
@@ -145,6 +165,21 @@ std::string const &abcg::Application::getBasePath() noexcept {
   return m_basePath;
 }
 
+/**
+ * @brief Returns the job system of the application.
+ *
+ * The job system is started by abcg::Application::run with one worker thread
+ * per hardware thread, minus one for the main thread. When the application is
+ * built for WebAssembly, there are no worker threads and jobs run on the thread
+ * that waits for them.
+ *
+ * @return Pointer to the job system, or nullptr if it is called outside
+ * abcg::Application::run.
+ */
+abcg::JobSystem *abcg::Application::getJobSystem() noexcept {
+  return m_jobSystem.get();
+}
+
 void abcg::Application::mainLoopIterator([[maybe_unused]] bool &done) const {
   SDL_Event event{};
   while (SDL_PollEvent(&event) != 0) {
@@ -156,3 +191,33 @@ void abcg::Application::mainLoopIterator([[maybe_unused]] bool &done) const {
   }
   m_window->templatePaint();
 }
+
+void abcg::Application::headlessLoop() const {
+  auto const &windowSettings{m_window->getWindowSettings()};
+  auto const maxFrames{windowSettings.headlessFrames};
+  auto const maxDuration{windowSettings.headlessDuration};
+
+  Timer timer;
+  std::size_t frames{};
+  while (true) {
+    m_window->templatePaint();
+    ++frames;
+
+    if (maxFrames == 0 && maxDuration <= 0.0)
+      break;
+    if (maxFrames > 0 && frames >= maxFrames)
+      break;
+    if (maxDuration > 0.0 && timer.elapsed() >= maxDuration)
+      break;
+  }
+
+  auto const elapsed{timer.elapsed()};
+  fmt::print("Headless run...: {} frames in {:.3f} s ({:.3f} ms/frame)\n",
+             frames, elapsed, elapsed * 1000.0 / gsl::narrow<double>(frames));
+
+  auto const stats{m_window->getFrameStats().getSummary()};
+  fmt::print("Frame times....: p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms, "
+             "max {:.3f} ms ({} hitches)\n",
+             stats.p50 * 1000.0, stats.p95 * 1000.0, stats.p99 * 1000.0,
+             stats.max * 1000.0, m_window->getFrameStats().getHitchCount());
+}
@@ -11,8 +11,11 @@
 #ifndef ABCG_APPLICATION_HPP_
 #define ABCG_APPLICATION_HPP_
 
+#include <memory>
 #include <string>
 
+#include "abcgJobSystem.hpp"
+
 #define ABCG_VERSION_MAJOR 3
 #define ABCG_VERSION_MINOR 1
 #define ABCG_VERSION_PATCH 0
@@ -33,6 +36,10 @@ void mainLoopCallback(void *userData);
  *
  * This is the class that starts an ABCg application, initializes the SDL
  * modules and enters the main event loop.
+ *
+ * If abcg::WindowSettings::headless is set, no SDL window is created and the
+ * main loop only repaints the window offscreen for a fixed number of frames
+ * or seconds.
  */
 class abcg::Application {
 public:
@@ -42,9 +49,11 @@ public:
 
   static std::string const &getAssetsPath() noexcept;
   static std::string const &getBasePath() noexcept;
+  static JobSystem *getJobSystem() noexcept;
 
 private:
   void mainLoopIterator(bool &done) const;
+  void headlessLoop() const;
 
   Window *m_window{};
 
@@ -56,6 +65,7 @@ private:
   // See https://bugs.llvm.org/show_bug.cgi?id=48040
   static inline std::string m_assetsPath;
   static inline std::string m_basePath;
+  static inline std::unique_ptr<JobSystem> m_jobSystem;
   // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
 };
 
@@ -0,0 +1,165 @@
+/**
+ * @file abcgFileWatcher.cpp
+ * @brief Definition of abcg::FileWatcher members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgFileWatcher.hpp"
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+namespace {
+[[nodiscard]] std::filesystem::file_time_type
+getLastWriteTime(std::filesystem::path const &path) {
+  std::error_code error;
+  auto const time{std::filesystem::last_write_time(path, error)};
+  return error ? std::filesystem::file_time_type{} : time;
+}
+} // namespace
+
+/**
+ * @brief Creates the watcher with no watched files.
+ */
+abcg::FileWatcher::FileWatcher() {
+#if defined(__linux__)
+  m_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+/**
+ * @brief Stops watching all files.
+ */
+abcg::FileWatcher::~FileWatcher() {
+#if defined(__linux__)
+  if (m_descriptor >= 0) {
+    close(m_descriptor);
+  }
+#endif
+}
+
+/**
+ * @brief Starts watching a file.
+ *
+ * @param path Path of the file.
+ *
+ * @returns `true` if the file is watched; `false` if the path is not of a
+ * regular file or could not be watched.
+ */
+bool abcg::FileWatcher::watch(std::string_view path) {
+  std::error_code error;
+  if (!std::filesystem::is_regular_file(path, error))
+    return false;
+  auto const normalPath{
+      std::filesystem::absolute(path, error).lexically_normal()};
+  if (error)
+    return false;
+
+  auto normalString{normalPath.string()};
+  if (std::ranges::any_of(m_files, [&normalString](auto const &file) {
+        return file.path == normalString;
+      }))
+    return true;
+
+#if defined(__linux__)
+  if (m_descriptor >= 0) {
+    // Watch the directory, as editors may replace the file instead of writing
+    // to it
+    auto const directory{normalPath.parent_path()};
+    auto const watchDescriptor{inotify_add_watch(
+        m_descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO)};
+    if (watchDescriptor < 0)
+      return false;
+    // The descriptor of a directory that is already watched is reused
+    m_directories.insert_or_assign(watchDescriptor, directory);
+  }
+#endif
+
+  m_files.push_back({.path = std::move(normalString),
+                     .lastWriteTime = getLastWriteTime(normalPath)});
+  return true;
+}
+
+/**
+ * @brief Stops watching all files.
+ */
+void abcg::FileWatcher::clear() {
+#if defined(__linux__)
+  for (auto const &directory : m_directories) {
+    inotify_rm_watch(m_descriptor, directory.first);
+  }
+#endif
+  m_directories.clear();
+  m_files.clear();
+}
+
+/**
+ * @brief Returns the watched files that changed since the last call.
+ *
+ * This function does not block.
+ *
+ * @returns Absolute paths of the files that changed.
+ */
+std::vector<std::string> abcg::FileWatcher::poll() {
+  std::vector<std::string> changedFiles;
+  auto const addChangedFile{[&changedFiles](std::string const &path) {
+    if (std::ranges::find(changedFiles, path) == changedFiles.end()) {
+      changedFiles.push_back(path);
+    }
+  }};
+
+#if defined(__linux__)
+  if (m_descriptor >= 0) {
+    auto const isWatched{[this](std::string const &path) {
+      return std::ranges::any_of(
+          m_files, [&path](auto const &file) { return file.path == path; });
+    }};
+
+    alignas(inotify_event) std::array<char, 4096> buffer{};
+    while (true) {
+      // Fails with EAGAIN when there are no more events
+      auto const length{read(m_descriptor, buffer.data(), buffer.size())};
+      if (length <= 0)
+        break;
+
+      for (std::size_t offset{}; offset < static_cast<std::size_t>(length);) {
+        inotify_event event{};
+        std::memcpy(&event, &buffer.at(offset), sizeof(inotify_event));
+        if (event.len > 0) {
+          auto const *name{&buffer.at(offset + sizeof(inotify_event))};
+          if (auto const directory{m_directories.find(event.wd)};
+              directory != m_directories.end()) {
+            auto const path{(directory->second / name).string()};
+            if (isWatched(path)) {
+              addChangedFile(path);
+            }
+          }
+        }
+        offset += sizeof(inotify_event) + event.len;
+      }
+    }
+    return changedFiles;
+  }
+#endif
+
+  for (auto &file : m_files) {
+    auto const lastWriteTime{getLastWriteTime(file.path)};
+    if (lastWriteTime != file.lastWriteTime) {
+      file.lastWriteTime = lastWriteTime;
+      addChangedFile(file.path);
+    }
+  }
+  return changedFiles;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file abcgFileWatcher.hpp
+ * @brief Header file of abcg::FileWatcher.
+ *
+ * Declaration of abcg::FileWatcher class.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_FILE_WATCHER_HPP_
+#define ABCG_FILE_WATCHER_HPP_
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace abcg {
+class FileWatcher;
+} // namespace abcg
+
+/**
+ * @brief Non-blocking watcher of changes to files.
+ *
+ * On Linux, the directories of the watched files are monitored with inotify,
+ * so that files replaced by editors that save to a temporary file and rename
+ * it are also reported. On other platforms, or if inotify is not available,
+ * the last write times of the files are compared on each call to
+ * abcg::FileWatcher::poll.
+ */
+class abcg::FileWatcher {
+public:
+  FileWatcher();
+  FileWatcher(FileWatcher const &) = delete;
+  FileWatcher(FileWatcher &&) = delete;
+  FileWatcher &operator=(FileWatcher const &) = delete;
+  FileWatcher &operator=(FileWatcher &&) = delete;
+  ~FileWatcher();
+
+  bool watch(std::string_view path);
+  void clear();
+
+  [[nodiscard]] std::vector<std::string> poll();
+
+private:
+  struct WatchedFile {
+    std::string path;
+    std::filesystem::file_time_type lastWriteTime{};
+  };
+
+  // inotify instance, or -1 if the last write times are compared instead
+  int m_descriptor{-1};
+  std::vector<WatchedFile> m_files;
+  // Directories monitored by inotify, by watch descriptor
+  std::unordered_map<int, std::filesystem::path> m_directories;
+};
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @file abcgFramePacer.cpp
+ * @brief Definition of abcg::FramePacer members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgFramePacer.hpp"
+
+#include <algorithm>
+#include <thread>
+
+using namespace std::chrono;
+
+namespace {
+// Time left before the deadline below which the pacer stops sleeping and
+// starts spinning
+constexpr microseconds spinThreshold{200};
+// Upper bound of the oversleep estimate
+constexpr milliseconds maxSleepOvershoot{4};
+} // namespace
+
+/**
+ * @brief Sets the target frame rate.
+ *
+ * @param targetFPS Target number of frames per second. Zero or a negative
+ * value disables pacing.
+ */
+void abcg::FramePacer::setTargetFPS(double targetFPS) {
+  if (targetFPS == m_targetFPS)
+    return;
+
+  m_targetFPS = targetFPS;
+  m_period = clock::duration::zero();
+  if (targetFPS > 0.0) {
+    m_period =
+        duration_cast<clock::duration>(duration<double>(1.0 / targetFPS));
+  }
+  reset();
+}
+
+/**
+ * @brief Returns the target frame rate.
+ *
+ * @returns Target number of frames per second, or zero if pacing is disabled.
+ */
+double abcg::FramePacer::getTargetFPS() const noexcept {
+  return m_period > clock::duration::zero() ? m_targetFPS : 0.0;
+}
+
+/**
+ * @brief Discards the current frame deadline.
+ *
+ * The next call to abcg::FramePacer::wait returns immediately and starts a new
+ * sequence of frame periods.
+ */
+void abcg::FramePacer::reset() noexcept { m_deadline = clock::time_point{}; }
+
+/**
+ * @brief Blocks the calling thread until the start of the next frame period.
+ *
+ * Returns immediately if pacing is disabled or if the deadline has already
+ * passed. If the frame is late by more than one period, the sequence of
+ * deadlines is restarted from the current time instead of trying to catch up.
+ */
+void abcg::FramePacer::wait() {
+  if (m_period <= clock::duration::zero())
+    return;
+
+  auto now{clock::now()};
+  if (m_deadline == clock::time_point{}) {
+    m_deadline = now + m_period;
+    return;
+  }
+
+  // Sleep while there is enough time left
+  while (m_deadline - now > m_sleepOvershoot + spinThreshold) {
+    auto const request{m_deadline - now - m_sleepOvershoot};
+    std::this_thread::sleep_for(request);
+    auto const after{clock::now()};
+
+    // Update the estimate with an exponential moving average (alpha = 1/8)
+    auto const overshoot{std::max(after - now - request, clock::duration{})};
+    m_sleepOvershoot += (overshoot - m_sleepOvershoot) / 8;
+    m_sleepOvershoot = std::min<clock::duration>(m_sleepOvershoot,
+                                                  maxSleepOvershoot);
+    now = after;
+  }
+
+  // Spin for the remaining time
+  while (now < m_deadline) {
+    std::this_thread::yield();
+    now = clock::now();
+  }
+
+  m_deadline += m_period;
+  if (m_deadline < now) {
+    m_deadline = now + m_period;
+  }
+}
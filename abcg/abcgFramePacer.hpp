@@ -0,0 +1,50 @@
+/**
+ * @file abcgFramePacer.hpp
+ * @brief Header file of abcg::FramePacer.
+ *
+ * Declaration of abcg::FramePacer class.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_FRAMEPACER_HPP_
+#define ABCG_FRAMEPACER_HPP_
+
+#include <chrono>
+
+namespace abcg {
+class FramePacer;
+} // namespace abcg
+
+/**
+ * @brief Limits the frame rate to a target number of frames per second.
+ *
+ * abcg::FramePacer::wait blocks until the start of the next frame period. Most
+ * of the wait is done by sleeping the thread; the last part is done by
+ * spinning, as the OS scheduler may oversleep. The amount of oversleep is
+ * estimated on the fly so that the pacer sleeps as much as possible without
+ * missing the deadline.
+ */
+class abcg::FramePacer {
+public:
+  void setTargetFPS(double targetFPS);
+  void wait();
+  void reset() noexcept;
+
+  [[nodiscard]] double getTargetFPS() const noexcept;
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  double m_targetFPS{};
+  clock::duration m_period{};
+  clock::time_point m_deadline{};
+
+  // Moving average of the time the thread sleeps beyond the requested amount
+  clock::duration m_sleepOvershoot{std::chrono::microseconds{500}};
+};
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * @file abcgFrameState.hpp
+ * @brief Header file of abcg::FrameState.
+ *
+ * Declaration and definition of abcg::FrameStateBase and abcg::FrameState.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_FRAME_STATE_HPP_
+#define ABCG_FRAME_STATE_HPP_
+
+#include <array>
+#include <cstddef>
+
+namespace abcg {
+class FrameStateBase;
+template <typename T> class FrameState;
+} // namespace abcg
+
+/**
+ * @brief Base class of a double-buffered state exchanged between the update
+ * and render stages of a frame.
+ *
+ * @sa abcg::FrameState.
+ */
+class abcg::FrameStateBase {
+public:
+  FrameStateBase() = default;
+  FrameStateBase(FrameStateBase const &) = default;
+  FrameStateBase(FrameStateBase &&) = default;
+  FrameStateBase &operator=(FrameStateBase const &) = default;
+  FrameStateBase &operator=(FrameStateBase &&) = default;
+  virtual ~FrameStateBase() = default;
+
+  /**
+   * @brief Publishes the state written by the update stage to the render
+   * stage.
+   */
+  virtual void swap() = 0;
+};
+
+/**
+ * @brief Double-buffered state of type `T` exchanged between the update and
+ * render stages of a frame.
+ *
+ * The update stage (e.g., abcg::OpenGLWindow::onUpdate) modifies the state
+ * returned by abcg::FrameState::write, while the render stage (e.g.,
+ * abcg::OpenGLWindow::onPaint) reads the state returned by
+ * abcg::FrameState::read. When abcg::WindowSettings::pipelinedUpdate is
+ * enabled, the two stages run concurrently on different threads, and the
+ * render stage sees the state of the previous update.
+ *
+ * The buffers are swapped by the window between frames, when neither stage is
+ * running. After a swap, the write buffer starts as a copy of the state just
+ * published, so the update stage can keep modifying its own previous state.
+ *
+ * Register the object with abcg::Window::registerFrameState.
+ *
+ * @tparam T Copy-assignable type of the state.
+ */
+template <typename T> class abcg::FrameState : public FrameStateBase {
+public:
+  /**
+   * @brief Returns the state to be modified by the update stage.
+   */
+  [[nodiscard]] T &write() { return m_states.at(m_writeIndex); }
+
+  /**
+   * @brief Returns the state to be read by the render stage.
+   */
+  [[nodiscard]] T const &read() const {
+    return m_states.at(1 - m_writeIndex);
+  }
+
+  void swap() override {
+    m_writeIndex = 1 - m_writeIndex;
+    m_states.at(m_writeIndex) = m_states.at(1 - m_writeIndex);
+  }
+
+private:
+  std::array<T, 2> m_states{};
+  std::size_t m_writeIndex{};
+};
+
+#endif
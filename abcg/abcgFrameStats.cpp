@@ -0,0 +1,204 @@
+/**
+ * @file abcgFrameStats.cpp
+ * @brief Definition of abcg::FrameStats members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgFrameStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "abcgExternal.hpp"
+
+namespace {
+// Number of frames between updates of the median used to detect hitches
+constexpr std::size_t medianUpdateInterval{16};
+
+// Nearest-rank percentile of sorted values
+[[nodiscard]] double percentile(std::vector<float> const &sorted,
+                                double const fraction) {
+  auto const rank{static_cast<std::size_t>(
+      std::ceil(fraction * static_cast<double>(sorted.size())))};
+  return sorted.at(std::clamp<std::size_t>(rank, 1, sorted.size()) - 1);
+}
+} // namespace
+
+/**
+ * @brief Records the time of a frame.
+ *
+ * The frame is counted as a hitch if its time is longer than the hitch factor
+ * times the median of the frame times recorded so far.
+ *
+ * @param frameTime Frame time, in seconds.
+ */
+void abcg::FrameStats::addFrame(double const frameTime) {
+  if (m_median > 0.0 && frameTime > m_hitchFactor * m_median) {
+    ++m_hitchCount;
+  }
+
+  m_frameTimes.at(m_next) = gsl::narrow_cast<float>(frameTime);
+  m_next = (m_next + 1) % historySize;
+  m_numFrames = std::min(m_numFrames + 1, historySize);
+
+  // Keep the median up to date on every frame until there are enough samples
+  if (++m_framesSinceMedian >= medianUpdateInterval ||
+      m_numFrames < medianUpdateInterval) {
+    updateMedian();
+  }
+}
+
+/**
+ * @brief Discards all recorded frame times and resets the hitch count.
+ */
+void abcg::FrameStats::reset() noexcept {
+  m_next = 0;
+  m_numFrames = 0;
+  m_hitchCount = 0;
+  m_median = 0.0;
+  m_framesSinceMedian = 0;
+}
+
+/**
+ * @brief Sets the threshold for counting a frame as a hitch.
+ *
+ * @param factor A frame is a hitch if its time is longer than this factor
+ * times the median frame time. The default is 2.
+ */
+void abcg::FrameStats::setHitchFactor(double const factor) noexcept {
+  m_hitchFactor = factor;
+}
+
+/**
+ * @brief Returns a recorded frame time.
+ *
+ * @param framesAgo Number of frames before the last recorded one. Zero returns
+ * the last frame time.
+ *
+ * @returns Frame time in seconds, or zero if there is no such frame.
+ */
+double abcg::FrameStats::getFrameTime(std::size_t const framesAgo) const {
+  if (framesAgo >= m_numFrames)
+    return 0.0;
+  return m_frameTimes.at((m_next + historySize - 1 - framesAgo) % historySize);
+}
+
+/**
+ * @brief Returns the threshold for counting a frame as a hitch.
+ *
+ * @returns Factor of the median frame time.
+ */
+double abcg::FrameStats::getHitchFactor() const noexcept {
+  return m_hitchFactor;
+}
+
+/**
+ * @brief Returns the number of hitches since the creation or last reset.
+ *
+ * Unlike abcg::FrameStatsSummary::hitches, this also counts hitches of frames
+ * no longer kept in the ring buffer.
+ *
+ * @returns Number of hitches.
+ */
+std::size_t abcg::FrameStats::getHitchCount() const noexcept {
+  return m_hitchCount;
+}
+
+/**
+ * @brief Returns the number of frame times kept in the ring buffer.
+ *
+ * @returns Number of frames, up to abcg::FrameStats::historySize.
+ */
+std::size_t abcg::FrameStats::getNumFrames() const noexcept {
+  return m_numFrames;
+}
+
+/**
+ * @brief Computes statistics of the frame times kept in the ring buffer.
+ *
+ * @returns Summary of the frame times. All values are zero if no frame has
+ * been recorded.
+ */
+abcg::FrameStatsSummary abcg::FrameStats::getSummary() const {
+  if (m_numFrames == 0)
+    return {};
+
+  std::vector<float> sorted(m_frameTimes.begin(),
+                            m_frameTimes.begin() +
+                                gsl::narrow<std::ptrdiff_t>(m_numFrames));
+  std::ranges::sort(sorted);
+
+  FrameStatsSummary summary{
+      .numFrames = m_numFrames,
+      .min = sorted.front(),
+      .p50 = percentile(sorted, 0.50),
+      .p95 = percentile(sorted, 0.95),
+      .p99 = percentile(sorted, 0.99),
+      .max = sorted.back(),
+      .mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) /
+              static_cast<double>(sorted.size())};
+
+  auto const threshold{m_hitchFactor * summary.p50};
+  summary.hitches = gsl::narrow<std::size_t>(std::ranges::count_if(
+      sorted, [threshold](double time) { return time > threshold; }));
+
+  return summary;
+}
+
+/**
+ * @brief Shows frame time statistics in the current ImGui window.
+ *
+ * The statistics are shown as text, followed by a plot of the raw frame times
+ * kept in the ring buffer, oldest first.
+ *
+ * @param summary Statistics to be shown, as returned by
+ * abcg::FrameStats::getSummary. They may be refreshed less often than the
+ * plot so that the text can be read.
+ * @param width Width of the plot, in pixels.
+ */
+void abcg::FrameStats::show(FrameStatsSummary const &summary,
+                            float const width) const {
+  if (summary.numFrames == 0)
+    return;
+
+  auto const toMs{[](double seconds) { return seconds * 1000.0; }};
+  auto const fpsLabel{fmt::format("{:.1f} FPS (mean {:.2f} ms)",
+                                  1.0 / summary.mean, toMs(summary.mean))};
+  auto const percentileLabel{fmt::format(
+      "p50 {:.2f}  p95 {:.2f}  p99 {:.2f} ms", toMs(summary.p50),
+      toMs(summary.p95), toMs(summary.p99))};
+  auto const rangeLabel{
+      fmt::format("min {:.2f}  max {:.2f} ms  hitches {}", toMs(summary.min),
+                  toMs(summary.max), summary.hitches)};
+  ImGui::TextUnformatted(fpsLabel.c_str());
+  ImGui::TextUnformatted(percentileLabel.c_str());
+  ImGui::TextUnformatted(rangeLabel.c_str());
+
+  // When the ring buffer is full, the oldest frame is the next to be
+  // overwritten
+  auto const offset{m_numFrames == historySize ? m_next : 0};
+  ImGui::PlotLines("", m_frameTimes.data(), gsl::narrow<int>(m_numFrames),
+                   gsl::narrow<int>(offset), nullptr, 0.0f,
+                   gsl::narrow_cast<float>(summary.max * 1.1),
+                   ImVec2(width, 40.0f));
+}
+
+void abcg::FrameStats::updateMedian() {
+  m_framesSinceMedian = 0;
+  if (m_numFrames == 0)
+    return;
+
+  std::vector<float> times(m_frameTimes.begin(),
+                           m_frameTimes.begin() +
+                               gsl::narrow<std::ptrdiff_t>(m_numFrames));
+  auto const middle{times.begin() +
+                    gsl::narrow<std::ptrdiff_t>(times.size() / 2)};
+  std::ranges::nth_element(times, middle);
+  m_median = *middle;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file abcgFrameStats.hpp
+ * @brief Header file of abcg::FrameStats.
+ *
+ * Declaration of abcg::FrameStats class and abcg::FrameStatsSummary
+ * structure.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_FRAMESTATS_HPP_
+#define ABCG_FRAMESTATS_HPP_
+
+#include <array>
+#include <cstddef>
+
+namespace abcg {
+struct FrameStatsSummary;
+class FrameStats;
+} // namespace abcg
+
+/**
+ * @brief Statistics of the frame times kept by abcg::FrameStats.
+ *
+ * Times are in seconds.
+ */
+struct abcg::FrameStatsSummary {
+  /** @brief Number of frames used to compute the statistics. */
+  std::size_t numFrames{};
+  /** @brief Shortest frame time. */
+  double min{};
+  /** @brief Median frame time. */
+  double p50{};
+  /** @brief 95th percentile of the frame times. */
+  double p95{};
+  /** @brief 99th percentile of the frame times. */
+  double p99{};
+  /** @brief Longest frame time. */
+  double max{};
+  /** @brief Mean frame time. */
+  double mean{};
+  /** @brief Number of hitches among the frames. */
+  std::size_t hitches{};
+};
+
+/**
+ * @brief Ring buffer of raw per-frame times.
+ *
+ * Unlike an averaged frame rate, the distribution of the frame times reveals
+ * stutter. A frame is counted as a hitch when its time is longer than
+ * abcg::FrameStats::getHitchFactor times the median frame time.
+ */
+class abcg::FrameStats {
+public:
+  /** @brief Maximum number of frame times kept. */
+  static constexpr std::size_t historySize{512};
+
+  void addFrame(double frameTime);
+  void reset() noexcept;
+  void setHitchFactor(double factor) noexcept;
+
+  [[nodiscard]] double getFrameTime(std::size_t framesAgo = 0) const;
+  [[nodiscard]] double getHitchFactor() const noexcept;
+  [[nodiscard]] std::size_t getHitchCount() const noexcept;
+  [[nodiscard]] std::size_t getNumFrames() const noexcept;
+  [[nodiscard]] FrameStatsSummary getSummary() const;
+
+  void show(FrameStatsSummary const &summary, float width) const;
+
+private:
+  void updateMedian();
+
+  std::array<float, historySize> m_frameTimes{};
+  // Index where the next frame time will be written
+  std::size_t m_next{};
+  std::size_t m_numFrames{};
+
+  double m_hitchFactor{2.0};
+  std::size_t m_hitchCount{};
+  // Median used to detect hitches, updated every few frames
+  double m_median{};
+  std::size_t m_framesSinceMedian{};
+};
+
+#endif
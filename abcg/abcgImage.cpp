@@ -13,13 +13,35 @@
 #include <cppitertools/itertools.hpp>
 #include <gsl/gsl>
 
+#include <functional>
 #include <span>
 #include <vector>
 
+#include "abcgApplication.hpp"
+
+namespace {
+// Number of rows processed by each job
+constexpr std::size_t rowsPerJob{64};
+
+// Calls body over subranges of [0, count), in parallel if the job system is
+// running
+void forEachRowRange(
+    std::size_t count,
+    std::function<void(std::size_t, std::size_t)> const &body) {
+  if (auto *jobSystem{abcg::Application::getJobSystem()};
+      jobSystem != nullptr) {
+    jobSystem->parallelFor(count, rowsPerJob, body);
+  } else {
+    body(0, count);
+  }
+}
+} // namespace
+
 /**
  * @brief Flips an image horizontally.
  *
- * Reverses each row of the image, in place.
+ * Reverses each row of the image, in place. Rows are processed in parallel by
+ * the job system of the application, if it is running.
  *
  * @param surface SDL surface of a RGB or RGBA image.
  */
@@ -30,28 +52,30 @@ void abcg::flipHorizontally(SDL_Surface &surface) {
   std::span const pixels{static_cast<std::byte *>(surface.pixels),
                          widthInBytes * height};
 
-  // Temporary row of pixels for the swap
-  std::vector<std::byte> pixelRow(gsl::narrow<std::size_t>(widthInBytes), {});
-
   SDL_LockSurface(&surface);
 
-  // For each row
-  for (auto const rowIndex : iter::range(height)) {
-    auto const rowStart{widthInBytes * rowIndex};
-    auto const rowEnd{rowStart + widthInBytes};
-    // For each pixel (RGB/RGA) of current row
-    auto srcBegin{pixels.begin() + gsl::narrow<long>(rowEnd)};
-    auto dstBegin{pixelRow.begin()};
-    for ([[maybe_unused]] auto const pixelIndex : iter::range(surface.w)) {
-      srcBegin -= bytesPerPixel;
-      std::copy(srcBegin, srcBegin + bytesPerPixel, dstBegin);
-      dstBegin += bytesPerPixel;
+  forEachRowRange(height, [&](std::size_t firstRow, std::size_t lastRow) {
+    // Temporary row of pixels for the swap
+    std::vector<std::byte> pixelRow(widthInBytes, {});
+
+    // For each row
+    for (auto const rowIndex : iter::range(firstRow, lastRow)) {
+      auto const rowStart{widthInBytes * rowIndex};
+      auto const rowEnd{rowStart + widthInBytes};
+      // For each pixel (RGB/RGA) of current row
+      auto srcBegin{pixels.begin() + gsl::narrow<long>(rowEnd)};
+      auto dstBegin{pixelRow.begin()};
+      for ([[maybe_unused]] auto const pixelIndex : iter::range(surface.w)) {
+        srcBegin -= bytesPerPixel;
+        std::copy(srcBegin, srcBegin + bytesPerPixel, dstBegin);
+        dstBegin += bytesPerPixel;
+      }
+      // std::ranges::copy(pixelRow, pixels.subspan(rowStart).begin());
+      std::copy(pixelRow.begin(),
+                pixelRow.begin() + gsl::narrow<long>(widthInBytes),
+                pixels.subspan(rowStart).begin());
     }
-    // std::ranges::copy(pixelRow, pixels.subspan(rowStart).begin());
-    std::copy(pixelRow.begin(),
-              pixelRow.begin() + gsl::narrow<long>(widthInBytes),
-              pixels.subspan(rowStart).begin());
-  }
+  });
 
   SDL_UnlockSurface(&surface);
 }
@@ -59,7 +83,8 @@ void abcg::flipHorizontally(SDL_Surface &surface) {
 /**
  * @brief Flips an image vertically.
  *
- * Reverses each column of the image, in place.
+ * Reverses each column of the image, in place. Rows are processed in parallel
+ * by the job system of the application, if it is running.
  *
  * @param surface SDL surface of a RGB or RGBA image.
  */
@@ -70,33 +95,35 @@ void abcg::flipVertically(SDL_Surface &surface) {
   std::span const pixels{static_cast<std::byte *>(surface.pixels),
                          gsl::narrow<std::size_t>(widthInBytes * height)};
 
-  // Temporary row of pixels for the swap
-  std::vector<std::byte> pixelRow(widthInBytes, std::byte{});
-
   SDL_LockSurface(&surface);
 
   // If height is odd, won't swap the middle row
-  for (auto const halfHeight{height / 2};
-       auto const rowIndex : iter::range(halfHeight)) {
-    auto const rowStartFromTop{widthInBytes * rowIndex};
-    auto const rowStartFromBottom{widthInBytes * (height - rowIndex - 1)};
-
-    auto const &topSpan{pixels.subspan(rowStartFromTop)};
-    auto const &bottomSpan{pixels.subspan(rowStartFromBottom)};
-
-    // std::ranges::copy(topSpan.subspan(0, widthInBytes), pixelRow.begin());
-    // std::ranges::copy(bottomSpan.subspan(0, widthInBytes), topSpan.begin());
-    // std::ranges::copy(pixelRow, bottomSpan.begin());
-    std::copy(topSpan.begin(),
-              topSpan.begin() + gsl::narrow<long>(widthInBytes),
-              pixelRow.begin());
-    std::copy(bottomSpan.begin(),
-              bottomSpan.begin() + gsl::narrow<long>(widthInBytes),
-              topSpan.begin());
-    std::copy(pixelRow.begin(),
-              pixelRow.begin() + gsl::narrow<long>(widthInBytes),
-              bottomSpan.begin());
-  }
+  forEachRowRange(height / 2, [&](std::size_t firstRow, std::size_t lastRow) {
+    // Temporary row of pixels for the swap
+    std::vector<std::byte> pixelRow(widthInBytes, std::byte{});
+
+    for (auto const rowIndex : iter::range(firstRow, lastRow)) {
+      auto const rowStartFromTop{widthInBytes * rowIndex};
+      auto const rowStartFromBottom{widthInBytes * (height - rowIndex - 1)};
+
+      auto const &topSpan{pixels.subspan(rowStartFromTop)};
+      auto const &bottomSpan{pixels.subspan(rowStartFromBottom)};
+
+      // std::ranges::copy(topSpan.subspan(0, widthInBytes), pixelRow.begin());
+      // std::ranges::copy(bottomSpan.subspan(0, widthInBytes),
+      //                   topSpan.begin());
+      // std::ranges::copy(pixelRow, bottomSpan.begin());
+      std::copy(topSpan.begin(),
+                topSpan.begin() + gsl::narrow<long>(widthInBytes),
+                pixelRow.begin());
+      std::copy(bottomSpan.begin(),
+                bottomSpan.begin() + gsl::narrow<long>(widthInBytes),
+                topSpan.begin());
+      std::copy(pixelRow.begin(),
+                pixelRow.begin() + gsl::narrow<long>(widthInBytes),
+                bottomSpan.begin());
+    }
+  });
 
   SDL_UnlockSurface(&surface);
 }
\ No newline at end of file
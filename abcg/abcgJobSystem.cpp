@@ -0,0 +1,222 @@
+/**
+ * @file abcgJobSystem.cpp
+ * @brief Definition of abcg::JobSystem and abcg::JobCounter members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgJobSystem.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <cppitertools/itertools.hpp>
+
+namespace {
+// Job system and queue index of the worker running on the current thread
+thread_local abcg::JobSystem const *currentJobSystem{};
+thread_local std::size_t currentQueueIndex{};
+} // namespace
+
+/**
+ * @brief Returns whether all jobs of the group have finished.
+ */
+bool abcg::JobCounter::isDone() const noexcept { return m_pending == 0; }
+
+/**
+ * @brief Constructs a job system and starts its worker threads.
+ *
+ * @param numWorkers Number of worker threads. If zero, jobs run only on the
+ * threads that wait for them.
+ */
+abcg::JobSystem::JobSystem(std::size_t numWorkers) {
+  m_queues.reserve(numWorkers + 1);
+  for ([[maybe_unused]] auto const index : iter::range(numWorkers + 1)) {
+    m_queues.push_back(std::make_unique<Queue>());
+  }
+
+  m_threads.reserve(numWorkers);
+  for (auto const index : iter::range(numWorkers)) {
+    m_threads.emplace_back(&JobSystem::workerLoop, this, index + 1);
+  }
+}
+
+/**
+ * @brief Stops and joins the worker threads.
+ *
+ * Jobs that have not started are discarded.
+ */
+abcg::JobSystem::~JobSystem() {
+  {
+    std::scoped_lock const lock{m_sleepMutex};
+    m_stop = true;
+  }
+  m_sleepCondition.notify_all();
+  for (auto &thread : m_threads) {
+    thread.join();
+  }
+}
+
+/**
+ * @brief Schedules a job to be run asynchronously.
+ *
+ * @param counter Counter of the group the job belongs to. It is incremented
+ * now and decremented when the job finishes.
+ * @param job Function to be called.
+ */
+void abcg::JobSystem::schedule(JobCounter &counter, Job job) {
+  ++counter.m_pending;
+
+  auto &queue{*m_queues.at(getQueueIndex())};
+  {
+    std::scoped_lock const lock{queue.mutex};
+    queue.tasks.push_back({std::move(job), &counter});
+  }
+
+  {
+    std::scoped_lock const lock{m_sleepMutex};
+    ++m_queuedTasks;
+  }
+  m_sleepCondition.notify_one();
+}
+
+/**
+ * @brief Blocks until all jobs of a group have finished.
+ *
+ * While waiting, the calling thread runs pending jobs.
+ *
+ * @param counter Counter of the group.
+ *
+ * @throw The first exception thrown by a job of the group, if any.
+ */
+void abcg::JobSystem::wait(JobCounter &counter) {
+  auto const queueIndex{getQueueIndex()};
+  while (!counter.isDone()) {
+    if (!runPendingTask(queueIndex)) {
+      std::this_thread::yield();
+    }
+  }
+
+  std::scoped_lock const lock{counter.m_exceptionMutex};
+  if (counter.m_exception) {
+    std::rethrow_exception(std::exchange(counter.m_exception, nullptr));
+  }
+}
+
+/**
+ * @brief Calls a function over subranges of [0, count) in parallel, and waits
+ * for all calls to finish.
+ *
+ * @param count Number of elements.
+ * @param grainSize Maximum number of elements of each subrange. If zero, the
+ * range is split evenly among the worker threads and the calling thread.
+ * @param body Function called with the first and one-past-last indices of each
+ * subrange.
+ *
+ * @throw The first exception thrown by @a body, if any.
+ */
+void abcg::JobSystem::parallelFor(
+    std::size_t count, std::size_t grainSize,
+    std::function<void(std::size_t, std::size_t)> const &body) {
+  if (count == 0)
+    return;
+  if (grainSize == 0) {
+    auto const numThreads{m_threads.size() + 1};
+    grainSize = (count + numThreads - 1) / numThreads;
+  }
+  if (grainSize >= count) {
+    body(0, count);
+    return;
+  }
+
+  JobCounter counter;
+  for (auto const begin : iter::range(std::size_t{0}, count, grainSize)) {
+    auto const end{std::min(begin + grainSize, count)};
+    schedule(counter, [&body, begin, end] { body(begin, end); });
+  }
+  wait(counter);
+}
+
+/**
+ * @brief Returns the number of worker threads.
+ */
+std::size_t abcg::JobSystem::getNumWorkers() const noexcept {
+  return m_threads.size();
+}
+
+/**
+ * @brief Returns the number of worker threads that keeps all hardware threads
+ * busy, taking into account the calling thread.
+ */
+std::size_t abcg::JobSystem::getDefaultNumWorkers() noexcept {
+  auto const hardwareThreads{std::thread::hardware_concurrency()};
+  return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+void abcg::JobSystem::workerLoop(std::size_t queueIndex) {
+  currentJobSystem = this;
+  currentQueueIndex = queueIndex;
+
+  while (true) {
+    if (runPendingTask(queueIndex))
+      continue;
+
+    std::unique_lock lock{m_sleepMutex};
+    m_sleepCondition.wait(lock, [this] { return m_stop || m_queuedTasks > 0; });
+    if (m_stop)
+      return;
+  }
+}
+
+// Pops the most recent task of the given queue, or steals the oldest task of
+// another queue, and runs it. Returns false if there is no pending task
+bool abcg::JobSystem::runPendingTask(std::size_t queueIndex) {
+  Task task;
+  auto found{false};
+
+  {
+    auto &queue{*m_queues.at(queueIndex)};
+    std::scoped_lock const lock{queue.mutex};
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      found = true;
+    }
+  }
+
+  for (auto const offset : iter::range(std::size_t{1}, m_queues.size())) {
+    if (found)
+      break;
+    auto &queue{*m_queues.at((queueIndex + offset) % m_queues.size())};
+    std::scoped_lock const lock{queue.mutex};
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      found = true;
+    }
+  }
+
+  if (!found)
+    return false;
+
+  --m_queuedTasks;
+
+  try {
+    task.job();
+  } catch (...) {
+    std::scoped_lock const lock{task.counter->m_exceptionMutex};
+    if (!task.counter->m_exception) {
+      task.counter->m_exception = std::current_exception();
+    }
+  }
+  --task.counter->m_pending;
+
+  return true;
+}
+
+std::size_t abcg::JobSystem::getQueueIndex() const noexcept {
+  return currentJobSystem == this ? currentQueueIndex : 0;
+}
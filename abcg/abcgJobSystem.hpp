@@ -0,0 +1,122 @@
+/**
+ * @file abcgJobSystem.hpp
+ * @brief Header file of abcg::JobSystem.
+ *
+ * Declaration of abcg::JobSystem and abcg::JobCounter classes.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_JOB_SYSTEM_HPP_
+#define ABCG_JOB_SYSTEM_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace abcg {
+class JobCounter;
+class JobSystem;
+} // namespace abcg
+
+/**
+ * @brief Counts the jobs of a group that have not finished yet.
+ *
+ * Pass the counter to abcg::JobSystem::schedule for each job of the group,
+ * and call abcg::JobSystem::wait to block until all of them have finished.
+ * A job can schedule other jobs on the same counter.
+ *
+ * @remark Objects of this type cannot be copied or moved.
+ */
+class abcg::JobCounter {
+public:
+  JobCounter() = default;
+  JobCounter(JobCounter const &) = delete;
+  JobCounter(JobCounter &&) = delete;
+  JobCounter &operator=(JobCounter const &) = delete;
+  JobCounter &operator=(JobCounter &&) = delete;
+  ~JobCounter() = default;
+
+  [[nodiscard]] bool isDone() const noexcept;
+
+private:
+  std::atomic<std::size_t> m_pending{};
+  std::mutex m_exceptionMutex;
+  std::exception_ptr m_exception;
+
+  friend JobSystem;
+};
+
+/**
+ * @brief Runs jobs on a pool of worker threads.
+ *
+ * Each worker thread has its own queue of jobs. Jobs scheduled from a worker
+ * are pushed to the queue of that worker, and jobs scheduled from any other
+ * thread are pushed to a shared queue. A worker runs the most recent job of
+ * its own queue first and, when the queue is empty, steals the oldest job of
+ * another queue.
+ *
+ * A thread waiting for a abcg::JobCounter runs pending jobs while it waits,
+ * so jobs may wait for other jobs without blocking a worker.
+ *
+ * An instance is created by abcg::Application::run and can be accessed with
+ * abcg::Application::getJobSystem.
+ *
+ * @remark Objects of this type cannot be copied or moved.
+ */
+class abcg::JobSystem {
+public:
+  /** @brief Type of a job. */
+  using Job = std::function<void()>;
+
+  explicit JobSystem(std::size_t numWorkers);
+  JobSystem(JobSystem const &) = delete;
+  JobSystem(JobSystem &&) = delete;
+  JobSystem &operator=(JobSystem const &) = delete;
+  JobSystem &operator=(JobSystem &&) = delete;
+  ~JobSystem();
+
+  void schedule(JobCounter &counter, Job job);
+  void wait(JobCounter &counter);
+  void parallelFor(std::size_t count, std::size_t grainSize,
+                   std::function<void(std::size_t, std::size_t)> const &body);
+
+  [[nodiscard]] std::size_t getNumWorkers() const noexcept;
+  [[nodiscard]] static std::size_t getDefaultNumWorkers() noexcept;
+
+private:
+  struct Task {
+    Job job;
+    JobCounter *counter{};
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void workerLoop(std::size_t queueIndex);
+  bool runPendingTask(std::size_t queueIndex);
+  [[nodiscard]] std::size_t getQueueIndex() const noexcept;
+
+  // Index 0 is the shared queue of non-worker threads
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::vector<std::thread> m_threads;
+
+  std::mutex m_sleepMutex;
+  std::condition_variable m_sleepCondition;
+  std::atomic<std::size_t> m_queuedTasks{};
+  bool m_stop{};
+};
+
+#endif
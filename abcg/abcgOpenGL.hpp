@@ -14,8 +14,14 @@
 #define ABCG_OPENGL_HPP_
 
 #include "abcg.hpp"
+#include "abcgOpenGLCallStats.hpp"
+#include "abcgOpenGLCommandList.hpp"
+#include "abcgOpenGLFrameUniforms.hpp"
+#include "abcgOpenGLGPUProfiler.hpp"
 #include "abcgOpenGLImage.hpp"
+#include "abcgOpenGLProgram.hpp"
 #include "abcgOpenGLShader.hpp"
+#include "abcgOpenGLStateCache.hpp"
 #include "abcgOpenGLWindow.hpp"
 
 #endif
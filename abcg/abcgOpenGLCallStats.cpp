@@ -0,0 +1,59 @@
+/**
+ * @file abcgOpenGLCallStats.cpp
+ * @brief Definition of abcg::OpenGLCallStats members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLCallStats.hpp"
+
+#include "abcgExternal.hpp"
+
+/**
+ * @brief Returns the call counters of the OpenGL context.
+ *
+ * @returns Reference to the singleton object.
+ */
+abcg::OpenGLCallStats &abcg::OpenGLCallStats::getInstance() {
+  static OpenGLCallStats stats;
+  return stats;
+}
+
+/**
+ * @brief Closes the counters of the current frame.
+ *
+ * The counts of the current frame become the counts of the last frame, and
+ * the counters of the next frame start from zero.
+ */
+void abcg::OpenGLCallStats::endFrame() noexcept {
+  m_last = m_current;
+  m_current = {};
+}
+
+/**
+ * @brief Shows call counts in the current ImGui window.
+ *
+ * @param counts Counts to be shown, as returned by
+ * abcg::OpenGLCallStats::getLastFrame.
+ */
+void abcg::OpenGLCallStats::show(OpenGLCallCounts const &counts) {
+  auto const drawLabel{fmt::format("Draws {} ({} indexed, {} instanced)",
+                                   counts.drawCalls, counts.indexedDrawCalls,
+                                   counts.instancedDrawCalls)};
+  auto const primitiveLabel{fmt::format(
+      "Primitives {} ({} indexed, {} instanced)", counts.primitives,
+      counts.indexedPrimitives, counts.instancedPrimitives)};
+  auto const stateLabel{fmt::format("State {}  Textures {}  Uniforms {}",
+                                    counts.stateChanges, counts.textureBinds,
+                                    counts.uniformUpdates)};
+  auto const uploadLabel{fmt::format(
+      "Uploads {:.1f} KiB",
+      static_cast<double>(counts.bufferUploadBytes) / 1024.0)};
+  ImGui::TextUnformatted(drawLabel.c_str());
+  ImGui::TextUnformatted(primitiveLabel.c_str());
+  ImGui::TextUnformatted(stateLabel.c_str());
+  ImGui::TextUnformatted(uploadLabel.c_str());
+}
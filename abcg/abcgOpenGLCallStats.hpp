@@ -0,0 +1,177 @@
+/**
+ * @file abcgOpenGLCallStats.hpp
+ * @brief Header file of abcg::OpenGLCallStats.
+ *
+ * Declaration of abcg::OpenGLCallStats class and abcg::OpenGLCallCounts
+ * structure.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_CALL_STATS_HPP_
+#define ABCG_OPENGL_CALL_STATS_HPP_
+
+#include <cstdint>
+
+#include "abcgOpenGLExternal.hpp"
+
+namespace abcg {
+struct OpenGLCallCounts;
+class OpenGLCallStats;
+} // namespace abcg
+
+/**
+ * @brief Number of OpenGL calls of each kind issued during a frame.
+ *
+ * Only calls issued through the wrappers in the abcg namespace are counted.
+ * Calls skipped by abcg::OpenGLStateCache are not counted.
+ */
+struct abcg::OpenGLCallCounts {
+  /** @brief Number of draw calls. */
+  std::uint64_t drawCalls{};
+  /** @brief Number of draw calls that read an index buffer. */
+  std::uint64_t indexedDrawCalls{};
+  /** @brief Number of instanced draw calls. */
+  std::uint64_t instancedDrawCalls{};
+  /** @brief Number of primitives drawn, including those drawn by indexed and
+   * instanced draw calls. */
+  std::uint64_t primitives{};
+  /** @brief Number of primitives drawn by indexed draw calls. */
+  std::uint64_t indexedPrimitives{};
+  /** @brief Number of primitives drawn by instanced draw calls. */
+  std::uint64_t instancedPrimitives{};
+  /** @brief Number of changes of pipeline state, such as program, buffer and
+   * vertex array bindings, capabilities and fixed-function settings. Texture
+   * binds and uniform updates are counted separately. */
+  std::uint64_t stateChanges{};
+  /** @brief Number of texture binds. */
+  std::uint64_t textureBinds{};
+  /** @brief Number of uniform updates. */
+  std::uint64_t uniformUpdates{};
+  /** @brief Number of bytes uploaded with `glBufferData` and
+   * `glBufferSubData`. */
+  std::uint64_t bufferUploadBytes{};
+};
+
+/**
+ * @brief Per-frame counters of the OpenGL calls issued through the wrappers.
+ *
+ * abcg::OpenGLWindow closes the counters of a frame after rendering the UI.
+ * The counts of the last complete frame are returned by
+ * abcg::OpenGLCallStats::getLastFrame and are shown in the FPS overlay.
+ *
+ * @remark The counters must be updated in the thread of the OpenGL context.
+ */
+class abcg::OpenGLCallStats {
+public:
+  static OpenGLCallStats &getInstance();
+
+  void endFrame() noexcept;
+
+  /** @brief Returns the counts of the frame being recorded. */
+  [[nodiscard]] OpenGLCallCounts const &getCurrentFrame() const noexcept {
+    return m_current;
+  }
+  /** @brief Returns the counts of the last complete frame. */
+  [[nodiscard]] OpenGLCallCounts const &getLastFrame() const noexcept {
+    return m_last;
+  }
+
+  void countDraw(GLenum mode, GLsizei count, bool indexed) noexcept;
+  void countInstancedDraw(GLenum mode, GLsizei count, GLsizei instances,
+                          bool indexed) noexcept;
+  /** @brief Counts a change of pipeline state. */
+  void countStateChange() noexcept { ++m_current.stateChanges; }
+  /** @brief Counts a texture bind. */
+  void countTextureBind() noexcept { ++m_current.textureBinds; }
+  /** @brief Counts a uniform update. */
+  void countUniformUpdate() noexcept { ++m_current.uniformUpdates; }
+  /** @brief Counts the upload of `size` bytes to a buffer. */
+  void countBufferUpload(GLsizeiptr const size) noexcept {
+    if (size > 0) {
+      m_current.bufferUploadBytes += static_cast<std::uint64_t>(size);
+    }
+  }
+
+  static void show(OpenGLCallCounts const &counts);
+
+private:
+  OpenGLCallStats() = default;
+
+  [[nodiscard]] static std::uint64_t primitiveCount(GLenum mode,
+                                                    GLsizei count) noexcept;
+
+  OpenGLCallCounts m_current{};
+  OpenGLCallCounts m_last{};
+};
+
+inline std::uint64_t
+abcg::OpenGLCallStats::primitiveCount(GLenum const mode,
+                                      GLsizei const count) noexcept {
+  if (count <= 0)
+    return 0;
+  auto const vertices{static_cast<std::uint64_t>(count)};
+  switch (mode) {
+  case GL_TRIANGLES:
+    return vertices / 3;
+  case GL_TRIANGLE_STRIP:
+  case GL_TRIANGLE_FAN:
+    return vertices < 3 ? 0 : vertices - 2;
+  case GL_LINES:
+    return vertices / 2;
+  case GL_LINE_STRIP:
+    return vertices < 2 ? 0 : vertices - 1;
+  case GL_LINE_LOOP:
+    return vertices < 2 ? 0 : vertices;
+  default:
+    return vertices;
+  }
+}
+
+/**
+ * @brief Counts a draw call.
+ *
+ * @param mode Primitive type.
+ * @param count Number of vertices or indices.
+ * @param indexed Whether the call reads an index buffer.
+ */
+inline void abcg::OpenGLCallStats::countDraw(GLenum const mode,
+                                             GLsizei const count,
+                                             bool const indexed) noexcept {
+  auto const primitives{primitiveCount(mode, count)};
+  ++m_current.drawCalls;
+  m_current.primitives += primitives;
+  if (indexed) {
+    ++m_current.indexedDrawCalls;
+    m_current.indexedPrimitives += primitives;
+  }
+}
+
+/**
+ * @brief Counts an instanced draw call.
+ *
+ * @param mode Primitive type.
+ * @param count Number of vertices or indices of each instance.
+ * @param instances Number of instances.
+ * @param indexed Whether the call reads an index buffer.
+ */
+inline void abcg::OpenGLCallStats::countInstancedDraw(
+    GLenum const mode, GLsizei const count, GLsizei const instances,
+    bool const indexed) noexcept {
+  auto const primitives{
+      primitiveCount(mode, count) *
+      static_cast<std::uint64_t>(instances > 0 ? instances : 0)};
+  ++m_current.drawCalls;
+  ++m_current.instancedDrawCalls;
+  m_current.primitives += primitives;
+  m_current.instancedPrimitives += primitives;
+  if (indexed) {
+    ++m_current.indexedDrawCalls;
+    m_current.indexedPrimitives += primitives;
+  }
+}
+
+#endif
@@ -0,0 +1,397 @@
+/**
+ * @file abcgOpenGLCommandList.cpp
+ * @brief Definition of abcg::OpenGLCommandList members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLCommandList.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <tuple>
+
+#include "abcgException.hpp"
+#include "abcgOpenGLFunction.hpp"
+
+namespace {
+template <typename T>
+[[nodiscard]] T readValue(std::span<std::byte const> const bytes) {
+  T value;
+  std::memcpy(&value, bytes.data(), sizeof(T));
+  return value;
+}
+} // namespace
+
+/**
+ * @brief Removes all commands and resets the recorded state.
+ *
+ * The allocated memory is kept for the next recording.
+ */
+void abcg::OpenGLCommandList::clear() noexcept {
+  m_draws.clear();
+  m_uniforms.clear();
+  m_program = 0;
+  m_vertexArray = 0;
+  m_numTextures = 0;
+  m_programUniforms.clear();
+}
+
+/**
+ * @brief Appends the draws of another list.
+ *
+ * The recorded state of this list is not changed.
+ *
+ * @param other List whose draws are appended.
+ */
+void abcg::OpenGLCommandList::append(OpenGLCommandList const &other) {
+  auto const uniformOffset{gsl::narrow<std::uint32_t>(m_uniforms.size())};
+  m_uniforms.insert(m_uniforms.end(), other.m_uniforms.begin(),
+                    other.m_uniforms.end());
+  m_draws.reserve(m_draws.size() + other.m_draws.size());
+  for (auto draw : other.m_draws) {
+    draw.firstUniform += uniformOffset;
+    m_draws.push_back(draw);
+  }
+}
+
+/**
+ * @brief Records the program used by the next draws.
+ *
+ * @param program Program name.
+ */
+void abcg::OpenGLCommandList::useProgram(GLuint const program) noexcept {
+  m_program = program;
+}
+
+/**
+ * @brief Records the vertex array used by the next draws.
+ *
+ * @param array Vertex array name.
+ */
+void abcg::OpenGLCommandList::bindVertexArray(GLuint const array) noexcept {
+  m_vertexArray = array;
+}
+
+/**
+ * @brief Records a texture used by the next draws.
+ *
+ * @param unit Index of the texture unit, starting from zero.
+ * @param target Texture target.
+ * @param texture Texture name.
+ *
+ * @throw abcg::RuntimeError if more than
+ * abcg::OpenGLCommandList::maxTextureBindings are recorded.
+ */
+void abcg::OpenGLCommandList::bindTexture(GLuint const unit,
+                                          GLenum const target,
+                                          GLuint const texture) {
+  auto const bindings{std::span{m_textures}.first(m_numTextures)};
+  if (auto iter{std::ranges::find_if(bindings,
+                                     [=](TextureBinding const &binding) {
+                                       return binding.unit == unit &&
+                                              binding.target == target;
+                                     })};
+      iter != bindings.end()) {
+    iter->texture = texture;
+    return;
+  }
+  if (m_numTextures == maxTextureBindings) {
+    throw abcg::RuntimeError(
+        fmt::format("Command lists support up to {} texture bindings per draw",
+                    maxTextureBindings));
+  }
+  m_textures.at(m_numTextures++) = {
+      .unit = unit, .target = target, .texture = texture};
+}
+
+/**
+ * @brief Records the value of an `int` or sampler uniform variable of the
+ * current program.
+ *
+ * @param location Uniform location.
+ * @param value Value of the variable.
+ */
+void abcg::OpenGLCommandList::uniform(GLint const location, int const value) {
+  setUniform(location, UniformType::Int, value);
+}
+
+/** @overload */
+void abcg::OpenGLCommandList::uniform(GLint const location,
+                                      float const value) {
+  setUniform(location, UniformType::Float, value);
+}
+
+/** @overload */
+void abcg::OpenGLCommandList::uniform(GLint const location,
+                                      glm::vec2 const &value) {
+  setUniform(location, UniformType::Vec2, value);
+}
+
+/** @overload */
+void abcg::OpenGLCommandList::uniform(GLint const location,
+                                      glm::vec3 const &value) {
+  setUniform(location, UniformType::Vec3, value);
+}
+
+/** @overload */
+void abcg::OpenGLCommandList::uniform(GLint const location,
+                                      glm::vec4 const &value) {
+  setUniform(location, UniformType::Vec4, value);
+}
+
+/** @overload */
+void abcg::OpenGLCommandList::uniform(GLint const location,
+                                      glm::mat3 const &value) {
+  setUniform(location, UniformType::Mat3, value);
+}
+
+/** @overload */
+void abcg::OpenGLCommandList::uniform(GLint const location,
+                                      glm::mat4 const &value) {
+  setUniform(location, UniformType::Mat4, value);
+}
+
+/**
+ * @brief Records a non-indexed draw with the current state.
+ *
+ * @param mode Primitive type.
+ * @param first Index of the first vertex.
+ * @param count Number of vertices.
+ * @param instances Number of instances. If different from 1, the draw is
+ * replayed with `glDrawArraysInstanced`.
+ */
+void abcg::OpenGLCommandList::drawArrays(GLenum const mode, GLint const first,
+                                         GLsizei const count,
+                                         GLsizei const instances) {
+  pushDraw({.mode = mode,
+            .indexType = GL_NONE,
+            .first = first,
+            .count = count,
+            .instances = instances});
+}
+
+/**
+ * @brief Records an indexed draw with the current state.
+ *
+ * @param mode Primitive type.
+ * @param count Number of indices.
+ * @param type Type of the indices.
+ * @param offset Offset of the first index in the element array buffer of the
+ * vertex array, in bytes.
+ * @param instances Number of instances. If different from 1, the draw is
+ * replayed with `glDrawElementsInstanced`.
+ */
+void abcg::OpenGLCommandList::drawElements(GLenum const mode,
+                                           GLsizei const count,
+                                           GLenum const type,
+                                           std::size_t const offset,
+                                           GLsizei const instances) {
+  pushDraw({.mode = mode,
+            .indexType = type,
+            .count = count,
+            .offset = offset,
+            .instances = instances});
+}
+
+/**
+ * @brief Issues the recorded draws.
+ *
+ * This must be called in the thread of the OpenGL context. Bindings and
+ * uniform values that are equal to those of the previous draw are not
+ * issued again. The program and vertex array bindings are reset to zero
+ * at the end.
+ *
+ * @param sortByState Whether to sort the draws by program, vertex array and
+ * textures. The recorded order is kept between draws of equal state. Set it
+ * to `false` if the order matters, e.g., for blending.
+ */
+void abcg::OpenGLCommandList::replay(bool const sortByState) const {
+  if (m_draws.empty())
+    return;
+
+  std::vector<std::size_t> order(m_draws.size());
+  std::iota(order.begin(), order.end(), std::size_t{});
+  if (sortByState) {
+    auto const key{[this](std::size_t index) {
+      auto const &draw{m_draws[index]};
+      return std::tuple{draw.program, draw.vertexArray, draw.numTextures,
+                        draw.textures[0].texture, draw.textures[1].texture,
+                        draw.textures[2].texture, draw.textures[3].texture};
+    }};
+    std::ranges::stable_sort(order, {}, key);
+  }
+
+  std::optional<GLuint> program;
+  std::optional<GLuint> vertexArray;
+  std::vector<TextureBinding> textures;
+  std::vector<ProgramUniforms> appliedUniforms;
+
+  for (auto const index : order) {
+    auto const &draw{m_draws[index]};
+
+    if (program != draw.program) {
+      program = draw.program;
+      glUseProgram(draw.program);
+    }
+    if (vertexArray != draw.vertexArray) {
+      vertexArray = draw.vertexArray;
+      glBindVertexArray(draw.vertexArray);
+    }
+
+    for (auto const &binding :
+         std::span{draw.textures}.first(draw.numTextures)) {
+      auto iter{std::ranges::find_if(textures, [&](TextureBinding const &b) {
+        return b.unit == binding.unit && b.target == binding.target;
+      })};
+      if (iter != textures.end() && iter->texture == binding.texture)
+        continue;
+      if (iter == textures.end()) {
+        textures.push_back(binding);
+      } else {
+        iter->texture = binding.texture;
+      }
+      glActiveTexture(GL_TEXTURE0 + binding.unit);
+      glBindTexture(binding.target, binding.texture);
+    }
+
+    auto &applied{findUniforms(appliedUniforms, draw.program)};
+    for (auto const &uniform :
+         std::span{m_uniforms}.subspan(draw.firstUniform, draw.numUniforms)) {
+      auto iter{std::ranges::find(applied, uniform.location,
+                                  &Uniform::location)};
+      if (iter != applied.end() && iter->type == uniform.type &&
+          iter->value == uniform.value)
+        continue;
+      if (iter == applied.end()) {
+        applied.push_back(uniform);
+      } else {
+        *iter = uniform;
+      }
+      applyUniform(uniform);
+    }
+
+    if (draw.indexType == GL_NONE) {
+      if (draw.instances == 1) {
+        glDrawArrays(draw.mode, draw.first, draw.count);
+      } else {
+        glDrawArraysInstanced(draw.mode, draw.first, draw.count,
+                              draw.instances);
+      }
+    } else {
+      // NOLINTNEXTLINE(performance-no-int-to-ptr)
+      auto const *indices{reinterpret_cast<void const *>(draw.offset)};
+      if (draw.instances == 1) {
+        glDrawElements(draw.mode, draw.count, draw.indexType, indices);
+      } else {
+        glDrawElementsInstanced(draw.mode, draw.count, draw.indexType, indices,
+                                draw.instances);
+      }
+    }
+  }
+
+  glBindVertexArray(0);
+  glUseProgram(0);
+}
+
+/**
+ * @brief Returns the number of recorded draws.
+ *
+ * @returns Number of draws.
+ */
+std::size_t abcg::OpenGLCommandList::getNumDraws() const noexcept {
+  return m_draws.size();
+}
+
+template <typename T>
+void abcg::OpenGLCommandList::setUniform(GLint const location,
+                                         UniformType const type,
+                                         T const &value) {
+  static_assert(sizeof(T) <= sizeof(Uniform::value));
+  // Values of inactive uniforms are ignored by OpenGL
+  if (location < 0)
+    return;
+
+  Uniform uniform{.location = location, .type = type};
+  std::memcpy(uniform.value.data(), &value, sizeof(T));
+
+  auto &uniforms{findUniforms(m_programUniforms, m_program)};
+  if (auto iter{
+          std::ranges::find(uniforms, location, &Uniform::location)};
+      iter != uniforms.end()) {
+    *iter = uniform;
+  } else {
+    uniforms.push_back(uniform);
+  }
+}
+
+void abcg::OpenGLCommandList::pushDraw(Draw draw) {
+  draw.program = m_program;
+  draw.vertexArray = m_vertexArray;
+  draw.textures = m_textures;
+  draw.numTextures = m_numTextures;
+
+  // Copy the uniform values of the program so that the draw can be reordered
+  auto const &uniforms{findUniforms(m_programUniforms, m_program)};
+  draw.firstUniform = gsl::narrow<std::uint32_t>(m_uniforms.size());
+  draw.numUniforms = gsl::narrow<std::uint32_t>(uniforms.size());
+  m_uniforms.insert(m_uniforms.end(), uniforms.begin(), uniforms.end());
+
+  m_draws.push_back(draw);
+}
+
+std::vector<abcg::OpenGLCommandList::Uniform> &
+abcg::OpenGLCommandList::findUniforms(std::vector<ProgramUniforms> &programs,
+                                      GLuint const program) {
+  if (auto iter{std::ranges::find(programs, program,
+                                  &ProgramUniforms::program)};
+      iter != programs.end()) {
+    return iter->uniforms;
+  }
+  return programs
+      .emplace_back(ProgramUniforms{.program = program, .uniforms = {}})
+      .uniforms;
+}
+
+void abcg::OpenGLCommandList::applyUniform(Uniform const &uniform) {
+  auto const bytes{std::span<std::byte const>{uniform.value}};
+  switch (uniform.type) {
+  case UniformType::Int:
+    glUniform1i(uniform.location, readValue<int>(bytes));
+    break;
+  case UniformType::Float:
+    glUniform1f(uniform.location, readValue<float>(bytes));
+    break;
+  case UniformType::Vec2: {
+    auto const value{readValue<glm::vec2>(bytes)};
+    glUniform2fv(uniform.location, 1, &value.x);
+    break;
+  }
+  case UniformType::Vec3: {
+    auto const value{readValue<glm::vec3>(bytes)};
+    glUniform3fv(uniform.location, 1, &value.x);
+    break;
+  }
+  case UniformType::Vec4: {
+    auto const value{readValue<glm::vec4>(bytes)};
+    glUniform4fv(uniform.location, 1, &value.x);
+    break;
+  }
+  case UniformType::Mat3: {
+    auto const value{readValue<glm::mat3>(bytes)};
+    glUniformMatrix3fv(uniform.location, 1, GL_FALSE, &value[0][0]);
+    break;
+  }
+  case UniformType::Mat4: {
+    auto const value{readValue<glm::mat4>(bytes)};
+    glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &value[0][0]);
+    break;
+  }
+  }
+}
@@ -0,0 +1,143 @@
+/**
+ * @file abcgOpenGLCommandList.hpp
+ * @brief Header file of abcg::OpenGLCommandList.
+ *
+ * Declaration of abcg::OpenGLCommandList class.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_COMMAND_LIST_HPP_
+#define ABCG_OPENGL_COMMAND_LIST_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "abcgExternal.hpp"
+#include "abcgOpenGLExternal.hpp"
+
+namespace abcg {
+class OpenGLCommandList;
+} // namespace abcg
+
+/**
+ * @brief Stream of draw commands that can be recorded on any thread and
+ * replayed later on the thread of the OpenGL context.
+ *
+ * Recording does not call OpenGL. Program, vertex array and texture bindings
+ * and uniform values are recorded as sticky state, as in OpenGL: each draw
+ * uses the bindings recorded before it and the uniform values recorded for
+ * its program since the program was bound. This state is copied into each
+ * draw, so that the draws can be reordered when the list is replayed.
+ *
+ * abcg::OpenGLCommandList::replay issues the commands through the wrappers in
+ * the abcg namespace. By default, draws are sorted by program, vertex array
+ * and textures, and bindings and uniform values that do not change between
+ * consecutive draws are not issued again.
+ *
+ * Lists recorded in parallel (e.g., by the jobs of abcg::JobSystem) can be
+ * merged with abcg::OpenGLCommandList::append.
+ *
+ * @remark A list must not be recorded by more than one thread at a time.
+ */
+class abcg::OpenGLCommandList {
+public:
+  /** @brief Maximum number of texture bindings of a draw. */
+  static constexpr std::size_t maxTextureBindings{4};
+
+  void clear() noexcept;
+  void append(OpenGLCommandList const &other);
+
+  void useProgram(GLuint program) noexcept;
+  void bindVertexArray(GLuint array) noexcept;
+  void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+  void uniform(GLint location, int value);
+  void uniform(GLint location, float value);
+  void uniform(GLint location, glm::vec2 const &value);
+  void uniform(GLint location, glm::vec3 const &value);
+  void uniform(GLint location, glm::vec4 const &value);
+  void uniform(GLint location, glm::mat3 const &value);
+  void uniform(GLint location, glm::mat4 const &value);
+
+  void drawArrays(GLenum mode, GLint first, GLsizei count,
+                  GLsizei instances = 1);
+  void drawElements(GLenum mode, GLsizei count, GLenum type,
+                    std::size_t offset = 0, GLsizei instances = 1);
+
+  void replay(bool sortByState = true) const;
+
+  [[nodiscard]] std::size_t getNumDraws() const noexcept;
+
+private:
+  enum class UniformType : std::uint8_t {
+    Int,
+    Float,
+    Vec2,
+    Vec3,
+    Vec4,
+    Mat3,
+    Mat4
+  };
+
+  struct Uniform {
+    GLint location{-1};
+    UniformType type{};
+    // Raw bytes of the value
+    std::array<std::byte, sizeof(glm::mat4)> value{};
+  };
+
+  struct TextureBinding {
+    GLuint unit{};
+    GLenum target{};
+    GLuint texture{};
+  };
+
+  struct Draw {
+    GLuint program{};
+    GLuint vertexArray{};
+    std::array<TextureBinding, maxTextureBindings> textures{};
+    std::uint32_t numTextures{};
+    // Range of the uniforms of this draw in m_uniforms
+    std::uint32_t firstUniform{};
+    std::uint32_t numUniforms{};
+    GLenum mode{};
+    // Index type, or GL_NONE for non-indexed draws
+    GLenum indexType{GL_NONE};
+    GLint first{};
+    GLsizei count{};
+    std::size_t offset{};
+    GLsizei instances{1};
+  };
+
+  // Uniform values of a program, one per location
+  struct ProgramUniforms {
+    GLuint program{};
+    std::vector<Uniform> uniforms;
+  };
+
+  template <typename T>
+  void setUniform(GLint location, UniformType type, T const &value);
+  void pushDraw(Draw draw);
+
+  static std::vector<Uniform> &
+  findUniforms(std::vector<ProgramUniforms> &programs, GLuint program);
+  static void applyUniform(Uniform const &uniform);
+
+  std::vector<Draw> m_draws;
+  std::vector<Uniform> m_uniforms;
+
+  // Sticky state of the recording
+  GLuint m_program{};
+  GLuint m_vertexArray{};
+  std::array<TextureBinding, maxTextureBindings> m_textures{};
+  std::uint32_t m_numTextures{};
+  std::vector<ProgramUniforms> m_programUniforms;
+};
+
+#endif
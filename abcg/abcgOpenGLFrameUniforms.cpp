@@ -0,0 +1,49 @@
+/**
+ * @file abcgOpenGLFrameUniforms.cpp
+ * @brief Definition of abcg::OpenGLFrameUniforms members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLFrameUniforms.hpp"
+
+#include "abcgOpenGLFunction.hpp"
+
+/**
+ * @brief Creates the buffer object and binds it to
+ * abcg::OpenGLFrameUniforms::bindingPoint.
+ *
+ * The buffer is initialized with a default-constructed abcg::FrameUniforms.
+ */
+void abcg::OpenGLFrameUniforms::create() {
+  destroy();
+  glGenBuffers(1, &m_buffer);
+  update({});
+}
+
+/**
+ * @brief Deletes the buffer object.
+ */
+void abcg::OpenGLFrameUniforms::destroy() {
+  glDeleteBuffers(1, &m_buffer);
+  m_buffer = 0;
+}
+
+/**
+ * @brief Uploads the uniform variables of the current frame.
+ *
+ * The data store is reallocated on each call, so that the driver can orphan
+ * the store that may still be in use by the draws of previous frames instead
+ * of waiting for them to finish.
+ *
+ * @param uniforms Values of the uniform variables.
+ */
+void abcg::OpenGLFrameUniforms::update(FrameUniforms const &uniforms) const {
+  glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), &uniforms,
+               GL_STREAM_DRAW);
+  glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, m_buffer);
+}
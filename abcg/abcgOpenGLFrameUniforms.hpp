@@ -0,0 +1,100 @@
+/**
+ * @file abcgOpenGLFrameUniforms.hpp
+ * @brief Header file of abcg::OpenGLFrameUniforms.
+ *
+ * Declaration of abcg::FrameUniforms structure and abcg::OpenGLFrameUniforms
+ * class.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_FRAME_UNIFORMS_HPP_
+#define ABCG_OPENGL_FRAME_UNIFORMS_HPP_
+
+#include <array>
+#include <cstddef>
+
+#include "abcgExternal.hpp"
+#include "abcgOpenGLExternal.hpp"
+
+namespace abcg {
+struct FrameUniforms;
+class OpenGLFrameUniforms;
+} // namespace abcg
+
+/**
+ * @brief Uniform variables that have the same value for every program in a
+ * frame.
+ *
+ * The layout of this structure matches the following `std140` uniform block:
+ * @code
+ * layout(std140) uniform FrameUniforms {
+ *   highp mat4 viewMatrix;
+ *   highp mat4 projMatrix;
+ *   highp vec4 lightDirWorldSpace;
+ *   highp vec4 Ia, Id, Is;
+ *   highp float time;
+ * };
+ * @endcode
+ *
+ * The block must be declared with the same members and precision qualifiers
+ * in every stage that uses it.
+ */
+struct abcg::FrameUniforms {
+  /** @brief View matrix. */
+  glm::mat4 viewMatrix{1.0f};
+  /** @brief Projection matrix. */
+  glm::mat4 projMatrix{1.0f};
+  /** @brief Light direction in world space. */
+  glm::vec4 lightDirWorldSpace{0.0f, 0.0f, -1.0f, 0.0f};
+  /** @brief Ambient light intensity. */
+  glm::vec4 Ia{1.0f};
+  /** @brief Diffuse light intensity. */
+  glm::vec4 Id{1.0f};
+  /** @brief Specular light intensity. */
+  glm::vec4 Is{1.0f};
+  /** @brief Time in seconds. */
+  float time{};
+  // The size of a std140 block is rounded up to a multiple of the size of a
+  // vec4
+  std::array<float, 3> padding{};
+};
+
+static_assert(offsetof(abcg::FrameUniforms, projMatrix) == 64);
+static_assert(offsetof(abcg::FrameUniforms, lightDirWorldSpace) == 128);
+static_assert(offsetof(abcg::FrameUniforms, Ia) == 144);
+static_assert(offsetof(abcg::FrameUniforms, time) == 192);
+static_assert(sizeof(abcg::FrameUniforms) == 208);
+
+/**
+ * @brief Uniform buffer object with the abcg::FrameUniforms of the current
+ * frame.
+ *
+ * Programs created with abcg::createOpenGLProgram,
+ * abcg::createOpenGLPrograms and abcg::checkOpenGLShaderLink have their
+ * `FrameUniforms` block, if any, bound to
+ * abcg::OpenGLFrameUniforms::bindingPoint. Updating the buffer once per frame
+ * replaces the uploads of the same uniform variables to each program.
+ */
+class abcg::OpenGLFrameUniforms {
+public:
+  /** @brief Name of the uniform block. */
+  static constexpr char const *blockName{"FrameUniforms"};
+  /** @brief Uniform buffer binding point of the uniform block. */
+  static constexpr GLuint bindingPoint{0};
+
+  void create();
+  void destroy();
+  void update(FrameUniforms const &uniforms) const;
+
+  /** @brief Returns the ID of the buffer object. */
+  [[nodiscard]] GLuint getID() const noexcept { return m_buffer; }
+
+private:
+  GLuint m_buffer{};
+};
+
+#endif
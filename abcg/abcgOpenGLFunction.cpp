@@ -12,6 +12,133 @@
 #include "abcgOpenGLError.hpp"
 
 #if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "abcgExternal.hpp"
+#include "abcgUtil.hpp"
+
+namespace {
+// Describes the calls that may have raised an error detected after them
+[[nodiscard]] std::string describeUncheckedCalls(std::uint64_t const first,
+                                                 std::uint64_t const end) {
+  if (first >= end) {
+    return "raised by a call made without the error checking wrappers";
+  }
+  return fmt::format("raised by one of the unchecked calls {0} to {1} of the "
+                     "frame; set ABCG_GL_CHECK_RANGE={0}:{1} to check them",
+                     first, end - 1);
+}
+
+// Message of the error reported by the debug callback for the current call
+// site
+thread_local std::string glDebugErrorMessage;
+
+void GLAPIENTRY debugMessageCallback(
+    [[maybe_unused]] GLenum source, GLenum type, [[maybe_unused]] GLuint id,
+    [[maybe_unused]] GLenum severity, GLsizei length, GLchar const *message,
+    [[maybe_unused]] void const *userParam) {
+  if (type != GL_DEBUG_TYPE_ERROR)
+    return;
+
+  std::string_view const text{message, length < 0 ? std::strlen(message)
+                                                  : std::size_t(length)};
+
+  // An exception cannot be thrown through the driver, so the error is thrown
+  // by the wrapper when the function returns
+  if (abcg::detail::glCallSite != nullptr) {
+    if (!abcg::detail::glDebugErrorPending) {
+      abcg::detail::glDebugErrorPending = true;
+      glDebugErrorMessage = text;
+    }
+    return;
+  }
+
+  // The error was generated by a function called without the error checking
+  // wrappers, e.g. by Dear ImGui
+  fmt::print("{}\n", abcg::toRedString(fmt::format(
+                         "OpenGL error outside of abcg wrappers: {}", text)));
+}
+} // namespace
+
+/**
+ * @brief Installs a KHR_debug callback for reporting OpenGL errors.
+ *
+ * When the callback is installed, the error checking wrappers no longer call
+ * `glGetError` before and after each function call. Instead, errors are
+ * reported by the driver through the callback, which runs synchronously in the
+ * thread that made the call. Errors are thrown as abcg::OpenGLError
+ * attributed to the source location of the wrapped call.
+ *
+ * The OpenGL context should be created with the debug flag. Otherwise, the
+ * driver may not report errors.
+ *
+ * @returns `true` if the callback was installed, or `false` if KHR_debug is
+ * not supported. In that case, errors are still checked with `glGetError`.
+ */
+bool abcg::installGLDebugCallback() {
+  if (!GLEW_KHR_debug && !GLEW_VERSION_4_3)
+    return false;
+
+  GLint contextFlags{};
+  ::glGetIntegerv(GL_CONTEXT_FLAGS, &contextFlags);
+  if ((contextFlags & GL_CONTEXT_FLAG_DEBUG_BIT) == 0) {
+    fmt::print("{}\n", toYellowString("Warning: OpenGL context has no debug "
+                                      "flag; errors may not be reported"));
+  }
+
+  ::glEnable(GL_DEBUG_OUTPUT);
+  ::glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  ::glDebugMessageCallback(debugMessageCallback, nullptr);
+  // Report errors only
+  ::glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr,
+                          GL_FALSE);
+  ::glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_ERROR, GL_DONT_CARE, 0,
+                          nullptr, GL_TRUE);
+
+  // Discard errors generated before the callback was installed
+  while (::glGetError() != GL_NO_ERROR) {
+  }
+
+  detail::glDebugCallbackInstalled = true;
+  return true;
+}
+
+/**
+ * @brief Removes the KHR_debug callback installed by
+ * abcg::installGLDebugCallback.
+ *
+ * Errors are checked again with `glGetError`.
+ */
+void abcg::uninstallGLDebugCallback() {
+  if (!detail::glDebugCallbackInstalled)
+    return;
+
+  detail::glDebugCallbackInstalled = false;
+  ::glDebugMessageCallback(nullptr, nullptr);
+  ::glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  ::glDisable(GL_DEBUG_OUTPUT);
+}
+
+/**
+ * @brief Throws the error reported by the KHR_debug callback during a wrapped
+ * function call.
+ *
+ * @param sourceLocation Information about the source code of the call.
+ *
+ * @throw abcg::OpenGLError.
+ */
+void abcg::throwGLDebugError(source_location const &sourceLocation) {
+  detail::glDebugErrorPending = false;
+  auto const message{std::exchange(glDebugErrorMessage, {})};
+  // The error flag is still set, as debug output does not clear it
+  throw abcg::OpenGLError(fmt::format("AFTER function call: {}", message),
+                          ::glGetError(), sourceLocation);
+}
+
 /**
  * @brief Checks OpenGL error status and throws on error with a log message.
  *
@@ -29,4 +156,143 @@ void abcg::checkGLError(source_location const &sourceLocation,
     throw abcg::OpenGLError(appendString, status, sourceLocation);
   }
 }
+
+/**
+ * @brief Checks OpenGL error status before a wrapped function call.
+ *
+ * If calls were made since the last check, the exception explanatory string
+ * contains the range of call indices that may have raised the error.
+ *
+ * @param sourceLocation Information about the source code, to be used for
+ * logging.
+ * @param callIndex Index of the call within the frame.
+ *
+ * @throw abcg::Exception::OpenGLError.
+ */
+void abcg::checkGLErrorBeforeCall(source_location const &sourceLocation,
+                                  std::uint64_t const callIndex) {
+  if (auto const status{glGetError()}; status != GL_NO_ERROR) {
+    auto const first{detail::glFirstUncheckedCall};
+    if (first >= callIndex) {
+      throw abcg::OpenGLError("BEFORE function call", status, sourceLocation);
+    }
+    throw abcg::OpenGLError(
+        fmt::format("BEFORE function call ({})",
+                    describeUncheckedCalls(first, callIndex)),
+        status, sourceLocation);
+  }
+}
+
+/**
+ * @brief Sets which calls of the error checking wrappers are checked with
+ * `glGetError`.
+ *
+ * @param policy Checking policy.
+ * @param interval Number of calls between checks, for
+ * abcg::OpenGLCheckPolicy::EveryNthCall.
+ */
+void abcg::setGLCheckPolicy(OpenGLCheckPolicy const policy,
+                            std::uint64_t const interval) {
+  detail::glCheckState.policy = policy;
+  detail::glCheckState.interval = std::max<std::uint64_t>(interval, 1);
+}
+
+/**
+ * @brief Sets a range of calls that are always checked.
+ *
+ * Call indices are counted from the start of each frame. When an error is
+ * detected after unchecked calls, the exception message contains the range of
+ * calls that may have raised it. Checking these calls in a new run pinpoints
+ * the faulty call, provided that the frames issue the same sequence of
+ * calls. The range can be bisected to check fewer calls per frame.
+ *
+ * The range can also be set with the environment variable
+ * `ABCG_GL_CHECK_RANGE` (see abcg::OpenGLSettings::errorCheckRange).
+ *
+ * @param first Index of the first call of the range.
+ * @param last Index of the last call of the range.
+ */
+void abcg::setGLCheckRange(std::uint64_t const first,
+                           std::uint64_t const last) noexcept {
+  detail::glCheckState.rangeFirst = first;
+  detail::glCheckState.rangeLast = last;
+}
+
+/**
+ * @brief Sets a range of calls that are always checked, from a string.
+ *
+ * @param range String in the format `first:last`.
+ *
+ * @throw abcg::RuntimeError if the string is not in the expected format.
+ *
+ * @sa abcg::setGLCheckRange(std::uint64_t, std::uint64_t).
+ */
+void abcg::setGLCheckRange(std::string_view const range) {
+  auto const separator{range.find(':')};
+  std::uint64_t first{};
+  std::uint64_t last{};
+  auto const parse{[](std::string_view str, std::uint64_t &value) {
+    auto const *end{str.data() + str.size()};
+    auto const [ptr, ec]{std::from_chars(str.data(), end, value)};
+    return ec == std::errc{} && ptr == end && !str.empty();
+  }};
+  if (separator == std::string_view::npos ||
+      !parse(range.substr(0, separator), first) ||
+      !parse(range.substr(separator + 1), last) || first > last) {
+    throw abcg::RuntimeError(
+        fmt::format("Invalid OpenGL check range \"{}\" (expected first:last)",
+                    range));
+  }
+  setGLCheckRange(first, last);
+}
+
+/**
+ * @brief Removes the range of calls that are always checked.
+ */
+void abcg::clearGLCheckRange() noexcept {
+  setGLCheckRange(std::numeric_limits<std::uint64_t>::max(), 0);
+}
+
+/**
+ * @brief Starts counting the calls of a new frame.
+ *
+ * This is called by abcg::OpenGLWindow at the beginning of each frame.
+ */
+void abcg::beginGLFrameChecks() noexcept {
+  detail::glCallCount = 0;
+  detail::glFirstUncheckedCall = 0;
+}
+
+/**
+ * @brief Checks OpenGL error status at the end of a frame.
+ *
+ * This is called by abcg::OpenGLWindow at the end of each frame. It detects
+ * errors raised by calls skipped by the checking policy, and by calls made
+ * without the error checking wrappers.
+ *
+ * @param sourceLocation Information about the source code, to be used for
+ * logging.
+ *
+ * @throw abcg::Exception::OpenGLError.
+ */
+void abcg::endGLFrameChecks(source_location const &sourceLocation) {
+  if (detail::glDebugCallbackInstalled)
+    return;
+
+  if (auto const status{glGetError()}; status != GL_NO_ERROR) {
+    throw abcg::OpenGLError(
+        fmt::format("at end of frame ({})",
+                    describeUncheckedCalls(detail::glFirstUncheckedCall,
+                                           detail::glCallCount)),
+        status, sourceLocation);
+  }
+}
+
+/**
+ * @brief Returns the number of calls of the error checking wrappers made
+ * since the start of the frame.
+ *
+ * @returns Number of calls.
+ */
+std::uint64_t abcg::getGLCallCount() noexcept { return detail::glCallCount; }
 #endif
@@ -28,10 +28,14 @@ using source_location = std::source_location;
 #endif
 #endif
 
+#include <cstdint>
+#include <limits>
 #include <string_view>
 #include <type_traits>
 
+#include "abcgOpenGLCallStats.hpp"
 #include "abcgOpenGLExternal.hpp"
+#include "abcgOpenGLStateCache.hpp"
 
 #if defined(_MSC_VER)
 // Disable "unreachable code" warnings for the case callGl is not specialized
@@ -41,14 +45,136 @@ using source_location = std::source_location;
 #endif
 
 namespace abcg {
+/**
+ * @brief Enumeration of policies that select which calls of the OpenGL error
+ * checking wrappers are checked with `glGetError` in debug builds.
+ *
+ * Regardless of the policy, calls made inside an abcg::OpenGLCheckRegion are
+ * always checked, and `glGetError` is called once at the end of each frame
+ * rendered by abcg::OpenGLWindow.
+ *
+ * @sa abcg::OpenGLSettings.
+ */
+enum class OpenGLCheckPolicy {
+  /** @brief Check before and after every call. */
+  EveryCall,
+  /** @brief Check before and after every Nth call of a frame. */
+  EveryNthCall,
+  /** @brief Check only at the end of each frame. */
+  PerFrame,
+  /** @brief Check only calls inside an abcg::OpenGLCheckRegion. */
+  MarkedRegions
+};
+
+class OpenGLCheckRegion;
+
 #if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
 
 void checkGLError(source_location const &sourceLocation,
                   std::string_view appendString);
+void checkGLErrorBeforeCall(source_location const &sourceLocation,
+                            std::uint64_t callIndex);
+bool installGLDebugCallback();
+void uninstallGLDebugCallback();
+[[noreturn]] void throwGLDebugError(source_location const &sourceLocation);
+
+void setGLCheckPolicy(OpenGLCheckPolicy policy, std::uint64_t interval = 64);
+void setGLCheckRange(std::uint64_t first, std::uint64_t last) noexcept;
+void setGLCheckRange(std::string_view range);
+void clearGLCheckRange() noexcept;
+void beginGLFrameChecks() noexcept;
+void endGLFrameChecks(
+    source_location const &sourceLocation = source_location::current());
+[[nodiscard]] std::uint64_t getGLCallCount() noexcept;
+
+// @cond Skipped by Doxygen
+namespace detail {
+// Calls selected by the current policy, and range of call indices that are
+// always checked
+struct GLCheckState {
+  OpenGLCheckPolicy policy{OpenGLCheckPolicy::EveryCall};
+  std::uint64_t interval{64};
+  std::uint64_t rangeFirst{std::numeric_limits<std::uint64_t>::max()};
+  std::uint64_t rangeLast{};
+};
+inline GLCheckState glCheckState;
+// Number of wrapped calls since the start of the frame
+inline std::uint64_t glCallCount{};
+// Index of the first call not checked after it was made
+inline std::uint64_t glFirstUncheckedCall{};
+// Nesting level of abcg::OpenGLCheckRegion objects on this thread
+inline thread_local int glCheckRegionDepth{};
+
+[[nodiscard]] inline bool isGLCallChecked(std::uint64_t callIndex) noexcept {
+  if (glCheckRegionDepth > 0 || (callIndex >= glCheckState.rangeFirst &&
+                                 callIndex <= glCheckState.rangeLast)) {
+    return true;
+  }
+  switch (glCheckState.policy) {
+  case OpenGLCheckPolicy::EveryCall:
+    return true;
+  case OpenGLCheckPolicy::EveryNthCall:
+    return callIndex % glCheckState.interval == 0;
+  default:
+    return false;
+  }
+}
+
+// Whether errors are reported by the KHR_debug callback instead of glGetError
+inline bool glDebugCallbackInstalled{};
+// Call site of the wrapped function being called on this thread, or nullptr
+// if the thread is not inside a wrapped call
+inline thread_local source_location const *glCallSite{};
+// Whether the debug callback has reported an error for the current call site
+inline thread_local bool glDebugErrorPending{};
+} // namespace detail
+// @endcond
+
+/**
+ * @brief Calls a function and checks for errors reported by the KHR_debug
+ * callback during the call.
+ *
+ * The debug output must be synchronous so that the callback runs on this
+ * thread before the function returns.
+ *
+ * @tparam TFun Function typename.
+ * @tparam TArgs Variadic arguments typename.
+ *
+ * @param sourceLocation Information about the source code, used for logging.
+ * @param function Function to be called.
+ * @param args Variadic template arguments for the function.
+ *
+ * @return Value returned from function, or void.
+ */
+template <typename TFun, typename... TArgs>
+auto callGLWithDebugCallback(source_location const &sourceLocation,
+                             TFun &&function, TArgs &&...args) {
+  detail::glCallSite = &sourceLocation;
+  if constexpr (!std::is_void_v<std::invoke_result_t<TFun, TArgs...>>) {
+    // Specialization for functions that do not return void
+    auto &&res{std::forward<TFun>(function)(std::forward<TArgs>(args)...)};
+    detail::glCallSite = nullptr;
+    if (detail::glDebugErrorPending) {
+      throwGLDebugError(sourceLocation);
+    }
+    return res;
+  }
+  // Specialization for functions that return void
+  std::forward<TFun>(function)(std::forward<TArgs>(args)...);
+  detail::glCallSite = nullptr;
+  if (detail::glDebugErrorPending) {
+    throwGLDebugError(sourceLocation);
+  }
+}
 
 /**
  * @brief Checks for OpenGL errors before and after a function call.
  *
+ * Only the calls selected by the policy set with abcg::setGLCheckPolicy are
+ * checked. If the KHR_debug callback is installed (see
+ * abcg::installGLDebugCallback), errors are reported by the callback and
+ * `glGetError` is not called.
+ *
  * @tparam TFun Function typename.
  * @tparam TArgs Variadic arguments typename.
  *
@@ -61,16 +187,27 @@ void checkGLError(source_location const &sourceLocation,
 template <typename TFun, typename... TArgs>
 auto callGL(source_location const &sourceLocation, TFun &&function,
             TArgs &&...args) {
-  checkGLError(sourceLocation, "BEFORE function call");
+  auto const callIndex{detail::glCallCount++};
+  if (detail::glDebugCallbackInstalled) {
+    return callGLWithDebugCallback(sourceLocation,
+                                   std::forward<TFun>(function),
+                                   std::forward<TArgs>(args)...);
+  }
+  if (!detail::isGLCallChecked(callIndex)) {
+    return std::forward<TFun>(function)(std::forward<TArgs>(args)...);
+  }
+  checkGLErrorBeforeCall(sourceLocation, callIndex);
   if constexpr (!std::is_void_v<std::invoke_result_t<TFun, TArgs...>>) {
     // Specialization for functions that do not return void
     auto &&res{std::forward<TFun>(function)(std::forward<TArgs>(args)...)};
     checkGLError(sourceLocation, "AFTER function call");
+    detail::glFirstUncheckedCall = callIndex + 1;
     return res;
   }
   // Specialization for functions that return void
   std::forward<TFun>(function)(std::forward<TArgs>(args)...);
   checkGLError(sourceLocation, "AFTER function call");
+  detail::glFirstUncheckedCall = callIndex + 1;
 }
 
 #else
@@ -112,6 +249,9 @@ auto callGL([[maybe_unused]] source_location, TFun &&function,
 inline void glActiveTexture(
     GLenum texture,
     source_location const &sourceLocation = source_location::current()) {
+  if (!OpenGLStateCache::getInstance().activeTexture(texture))
+    return;
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glActiveTexture, texture);
 }
 inline void glAttachShader(
@@ -127,56 +267,71 @@ inline void glBindAttribLocation(
 inline void glBindBuffer(
     GLenum target, GLuint buffer,
     source_location const &sourceLocation = source_location::current()) {
+  if (!OpenGLStateCache::getInstance().bindBuffer(target, buffer))
+    return;
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glBindBuffer, target, buffer);
 }
 inline void glBindFramebuffer(
     GLenum target, GLuint framebuffer,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glBindFramebuffer, target, framebuffer);
 }
 inline void glBindRenderbuffer(
     GLenum target, GLuint renderbuffer,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glBindRenderbuffer, target, renderbuffer);
 }
 inline void glBindTexture(
     GLenum target, GLuint texture,
     source_location const &sourceLocation = source_location::current()) {
+  if (!OpenGLStateCache::getInstance().bindTexture(target, texture))
+    return;
+  OpenGLCallStats::getInstance().countTextureBind();
   callGL(sourceLocation, ::glBindTexture, target, texture);
 }
 inline void glBlendColor(
     GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glBlendColor, red, green, blue, alpha);
 }
 inline void glBlendEquation(GLenum mode, source_location const &sourceLocation =
                                              source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glBlendEquation, mode);
 }
 inline void glBlendEquationSeparate(
     GLenum modeRGB, GLenum modeAlpha,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glBlendEquationSeparate, modeRGB, modeAlpha);
 }
 inline void glBlendFunc(
     GLenum sfactor, GLenum dfactor,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glBlendFunc, sfactor, dfactor);
 }
 inline void glBlendFuncSeparate(
     GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glBlendFuncSeparate, srcRGB, dstRGB, srcAlpha,
          dstAlpha);
 }
 inline void glBufferData(
     GLenum target, GLsizeiptr size, void const *data, GLenum usage,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countBufferUpload(size);
   callGL(sourceLocation, ::glBufferData, target, size, data, usage);
 }
 inline void glBufferSubData(
     GLenum target, GLintptr offset, GLsizeiptr size, void const *data,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countBufferUpload(size);
   callGL(sourceLocation, ::glBufferSubData, target, offset, size, data);
 }
 inline GLenum glCheckFramebufferStatus(
@@ -192,19 +347,23 @@ glClear(GLbitfield mask,
 inline void glClearColor(
     GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glClearColor, red, green, blue, alpha);
 }
 inline void glClearDepthf(GLfloat d, source_location const &sourceLocation =
                                          source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glClearDepthf, d);
 }
 inline void glClearStencil(GLint s, source_location const &sourceLocation =
                                         source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glClearStencil, s);
 }
 inline void glColorMask(
     GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glColorMask, red, green, blue, alpha);
 }
 inline void glCompileShader(
@@ -252,6 +411,7 @@ inline GLuint glCreateShader(
 inline void
 glCullFace(GLenum mode,
            source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   return callGL(sourceLocation, ::glCullFace, mode);
 }
 inline void glDeleteBuffers(
@@ -259,6 +419,8 @@ inline void glDeleteBuffers(
     source_location const &sourceLocation = source_location::current()) {
   if (buffers == nullptr || *buffers == 0)
     return;
+  OpenGLStateCache::getInstance().forgetBuffers(
+      {buffers, static_cast<std::size_t>(n)});
   callGL(sourceLocation, ::glDeleteBuffers, n, buffers);
 }
 inline void glDeleteFramebuffers(
@@ -273,6 +435,7 @@ inline void glDeleteProgram(
     source_location const &sourceLocation = source_location::current()) {
   if (program == 0)
     return;
+  OpenGLStateCache::getInstance().forgetProgram(program);
   callGL(sourceLocation, ::glDeleteProgram, program);
 }
 inline void glDeleteRenderbuffers(
@@ -294,19 +457,24 @@ inline void glDeleteTextures(
     source_location const &sourceLocation = source_location::current()) {
   if (textures == nullptr || *textures == 0)
     return;
+  OpenGLStateCache::getInstance().forgetTextures(
+      {textures, static_cast<std::size_t>(n)});
   callGL(sourceLocation, ::glDeleteTextures, n, textures);
 }
 inline void glDepthFunc(GLenum func, source_location const &sourceLocation =
                                          source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glDepthFunc, func);
 }
 inline void glDepthMask(GLboolean flag, source_location const &sourceLocation =
                                             source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glDepthMask, flag);
 }
 inline void glDepthRangef(
     GLfloat n, GLfloat f,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glDepthRangef, n, f);
 }
 inline void glDetachShader(
@@ -317,31 +485,41 @@ inline void glDetachShader(
 inline void
 glDisable(GLenum cap,
           source_location const &sourceLocation = source_location::current()) {
+  if (!OpenGLStateCache::getInstance().setCapability(cap, false))
+    return;
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glDisable, cap);
 }
 inline void glDisableVertexAttribArray(
     GLuint index,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glDisableVertexAttribArray, index);
 }
 inline void glDrawArrays(
     GLenum mode, GLint first, GLsizei count,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countDraw(mode, count, false);
   callGL(sourceLocation, ::glDrawArrays, mode, first, count);
 }
 inline void glDrawElements(
     GLenum mode, GLsizei count, GLenum type, void const *indices,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countDraw(mode, count, true);
   callGL(sourceLocation, ::glDrawElements, mode, count, type, indices);
 }
 inline void
 glEnable(GLenum cap,
          source_location const &sourceLocation = source_location::current()) {
+  if (!OpenGLStateCache::getInstance().setCapability(cap, true))
+    return;
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glEnable, cap);
 }
 inline void glEnableVertexAttribArray(
     GLuint index,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glEnableVertexAttribArray, index);
 }
 inline void
@@ -368,6 +546,7 @@ inline void glFramebufferTexture2D(
 }
 inline void glFrontFace(GLenum mode, source_location const &sourceLocation =
                                          source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glFrontFace, mode);
 }
 inline void glGenBuffers(
@@ -570,6 +749,7 @@ inline GLboolean glIsTexture(
 }
 inline void glLineWidth(GLfloat width, source_location const &sourceLocation =
                                            source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glLineWidth, width);
 }
 inline void glLinkProgram(
@@ -580,11 +760,13 @@ inline void glLinkProgram(
 inline void glPixelStorei(
     GLenum pname, GLint param,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glPixelStorei, pname, param);
 }
 inline void glPolygonOffset(
     GLfloat factor, GLfloat units,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glPolygonOffset, factor, units);
 }
 inline void glReadPixels(
@@ -607,11 +789,13 @@ inline void glRenderbufferStorage(
 inline void glSampleCoverage(
     GLfloat value, GLboolean invert,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glSampleCoverage, value, invert);
 }
 inline void
 glScissor(GLint x, GLint y, GLsizei width, GLsizei height,
           source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glScissor, x, y, width, height);
 }
 inline void glShaderBinary(
@@ -629,30 +813,36 @@ inline void glShaderSource(
 inline void glStencilFunc(
     GLenum func, GLint ref, GLuint mask,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glStencilFunc, func, ref, mask);
 }
 inline void glStencilFuncSeparate(
     GLenum face, GLenum func, GLint ref, GLuint mask,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glStencilFuncSeparate, face, func, ref, mask);
 }
 inline void glStencilMask(GLuint mask, source_location const &sourceLocation =
                                            source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glStencilMask, mask);
 }
 inline void glStencilMaskSeparate(
     GLenum face, GLuint mask,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glStencilMaskSeparate, face, mask);
 }
 inline void glStencilOp(
     GLenum fail, GLenum zfail, GLenum zpass,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glStencilOp, fail, zfail, zpass);
 }
 inline void glStencilOpSeparate(
     GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glStencilOpSeparate, face, sfail, dpfail, dppass);
 }
 inline void glTexImage2D(
@@ -666,21 +856,30 @@ inline void glTexImage2D(
 inline void glTexParameterf(
     GLenum target, GLenum pname, GLfloat param,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLStateCache::getInstance().forgetTexParameter(target, pname);
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glTexParameterf, target, pname, param);
 }
 inline void glTexParameterfv(
     GLenum target, GLenum pname, GLfloat const *params,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLStateCache::getInstance().forgetTexParameter(target, pname);
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glTexParameterfv, target, pname, params);
 }
 inline void glTexParameteri(
     GLenum target, GLenum pname, GLint param,
     source_location const &sourceLocation = source_location::current()) {
+  if (!OpenGLStateCache::getInstance().texParameteri(target, pname, param))
+    return;
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glTexParameteri, target, pname, param);
 }
 inline void glTexParameteriv(
     GLenum target, GLenum pname, GLint const *params,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLStateCache::getInstance().forgetTexParameter(target, pname);
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glTexParameteriv, target, pname, params);
 }
 inline void glTexSubImage2D(
@@ -693,103 +892,125 @@ inline void glTexSubImage2D(
 inline void glUniform1f(
     GLint location, GLfloat v0,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform1f, location, v0);
 }
 inline void glUniform1fv(
     GLint location, GLsizei count, GLfloat const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform1fv, location, count, value);
 }
 inline void glUniform1i(
     GLint location, GLint v0,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform1i, location, v0);
 }
 inline void glUniform1iv(
     GLint location, GLsizei count, GLint const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform1iv, location, count, value);
 }
 inline void glUniform2f(
     GLint location, GLfloat v0, GLfloat v1,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform2f, location, v0, v1);
 }
 inline void glUniform2fv(
     GLint location, GLsizei count, GLfloat const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform2fv, location, count, value);
 }
 inline void glUniform2i(
     GLint location, GLint v0, GLint v1,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform2i, location, v0, v1);
 }
 inline void glUniform2iv(
     GLint location, GLsizei count, GLint const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform2iv, location, count, value);
 }
 inline void glUniform3f(
     GLint location, GLfloat v0, GLfloat v1, GLfloat v2,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform3f, location, v0, v1, v2);
 }
 inline void glUniform3fv(
     GLint location, GLsizei count, GLfloat const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform3fv, location, count, value);
 }
 inline void glUniform3i(
     GLint location, GLint v0, GLint v1, GLint v2,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform3i, location, v0, v1, v2);
 }
 inline void glUniform3iv(
     GLint location, GLsizei count, GLint const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform3iv, location, count, value);
 }
 inline void glUniform4f(
     GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform4f, location, v0, v1, v2, v3);
 }
 inline void glUniform4fv(
     GLint location, GLsizei count, GLfloat const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform4fv, location, count, value);
 }
 inline void glUniform4i(
     GLint location, GLint v0, GLint v1, GLint v2, GLint v3,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform4i, location, v0, v1, v2, v3);
 }
 inline void glUniform4iv(
     GLint location, GLsizei count, GLint const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform4iv, location, count, value);
 }
 inline void glUniformMatrix2fv(
     GLint location, GLsizei count, GLboolean transpose, GLfloat const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniformMatrix2fv, location, count, transpose,
          value);
 }
 inline void glUniformMatrix3fv(
     GLint location, GLsizei count, GLboolean transpose, GLfloat const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniformMatrix3fv, location, count, transpose,
          value);
 }
 inline void glUniformMatrix4fv(
     GLint location, GLsizei count, GLboolean transpose, GLfloat const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniformMatrix4fv, location, count, transpose,
          value);
 }
 inline void glUseProgram(GLuint program, source_location const &sourceLocation =
                                              source_location::current()) {
+  if (!OpenGLStateCache::getInstance().useProgram(program))
+    return;
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glUseProgram, program);
 }
 inline void glValidateProgram(
@@ -841,12 +1062,14 @@ inline void glVertexAttribPointer(
     GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride,
     void const *pointer,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glVertexAttribPointer, index, size, type, normalized,
          stride, pointer);
 }
 inline void
 glViewport(GLint x, GLint y, GLsizei width, GLsizei height,
            source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glViewport, x, y, width, height);
 }
 
@@ -854,12 +1077,14 @@ glViewport(GLint x, GLint y, GLsizei width, GLsizei height,
 
 inline void glReadBuffer(GLenum src, source_location const &sourceLocation =
                                          source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glReadBuffer, src);
 }
 inline void glDrawRangeElements(
     GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type,
     void const *indices,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countDraw(mode, count, true);
   callGL(sourceLocation, ::glDrawRangeElements, mode, start, end, count, type,
          indices);
 }
@@ -950,41 +1175,48 @@ inline void glGetBufferPointerv(
 inline void glDrawBuffers(
     GLsizei n, GLenum const *bufs,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glDrawBuffers, n, bufs);
 }
 inline void glUniformMatrix2x3fv(
     GLint location, GLsizei count, GLboolean transpose, GLfloat const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniformMatrix2x3fv, location, count, transpose,
          value);
 }
 inline void glUniformMatrix3x2fv(
     GLint location, GLsizei count, GLboolean transpose, GLfloat const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniformMatrix3x2fv, location, count, transpose,
          value);
 }
 inline void glUniformMatrix2x4fv(
     GLint location, GLsizei count, GLboolean transpose, GLfloat const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniformMatrix2x4fv, location, count, transpose,
          value);
 }
 inline void glUniformMatrix4x2fv(
     GLint location, GLsizei count, GLboolean transpose, GLfloat const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniformMatrix4x2fv, location, count, transpose,
          value);
 }
 inline void glUniformMatrix3x4fv(
     GLint location, GLsizei count, GLboolean transpose, GLfloat const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniformMatrix3x4fv, location, count, transpose,
          value);
 }
 inline void glUniformMatrix4x3fv(
     GLint location, GLsizei count, GLboolean transpose, GLfloat const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniformMatrix4x3fv, location, count, transpose,
          value);
 }
@@ -1022,11 +1254,16 @@ inline void glFlushMappedBufferRange(
 inline void glBindVertexArray(
     GLuint array,
     source_location const &sourceLocation = source_location::current()) {
+  if (!OpenGLStateCache::getInstance().bindVertexArray(array))
+    return;
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glBindVertexArray, array);
 }
 inline void glDeleteVertexArrays(
     GLsizei n, GLuint const *arrays,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLStateCache::getInstance().forgetVertexArrays(
+      {arrays, static_cast<std::size_t>(n)});
   callGL(sourceLocation, ::glDeleteVertexArrays, n, arrays);
 }
 inline void glGenVertexArrays(
@@ -1057,12 +1294,16 @@ inline void glBindBufferRange(
     GLenum target, GLuint index, GLuint buffer, GLintptr offset,
     GLsizeiptr size,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLStateCache::getInstance().setBufferBinding(target, buffer);
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glBindBufferRange, target, index, buffer, offset,
          size);
 }
 inline void glBindBufferBase(
     GLenum target, GLuint index, GLuint buffer,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLStateCache::getInstance().setBufferBinding(target, buffer);
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glBindBufferBase, target, index, buffer);
 }
 inline void glTransformFeedbackVaryings(
@@ -1082,6 +1323,7 @@ inline void glGetTransformFeedbackVarying(
 inline void glVertexAttribIPointer(
     GLuint index, GLint size, GLenum type, GLsizei stride, void const *pointer,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glVertexAttribIPointer, index, size, type, stride,
          pointer);
 }
@@ -1128,41 +1370,49 @@ inline GLint glGetFragDataLocation(
 inline void glUniform1ui(
     GLint location, GLuint v0,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform1ui, location, v0);
 }
 inline void glUniform2ui(
     GLint location, GLuint v0, GLuint v1,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform2ui, location, v0, v1);
 }
 inline void glUniform3ui(
     GLint location, GLuint v0, GLuint v1, GLuint v2,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform3ui, location, v0, v1, v2);
 }
 inline void glUniform4ui(
     GLint location, GLuint v0, GLuint v1, GLuint v2, GLuint v3,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform4ui, location, v0, v1, v2, v3);
 }
 inline void glUniform1uiv(
     GLint location, GLsizei count, GLuint const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform1uiv, location, count, value);
 }
 inline void glUniform2uiv(
     GLint location, GLsizei count, GLuint const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform2uiv, location, count, value);
 }
 inline void glUniform3uiv(
     GLint location, GLsizei count, GLuint const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform3uiv, location, count, value);
 }
 inline void glUniform4uiv(
     GLint location, GLsizei count, GLuint const *value,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countUniformUpdate();
   callGL(sourceLocation, ::glUniform4uiv, location, count, value);
 }
 inline void glClearBufferiv(
@@ -1233,6 +1483,7 @@ inline void glGetActiveUniformBlockName(
 inline void glUniformBlockBinding(
     GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glUniformBlockBinding, program, uniformBlockIndex,
          uniformBlockBinding);
 }
@@ -1240,6 +1491,8 @@ inline void glUniformBlockBinding(
 inline void glDrawArraysInstanced(
     GLenum mode, GLint first, GLsizei count, GLsizei instancecount,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countInstancedDraw(mode, count, instancecount,
+                                                   false);
   callGL(sourceLocation, ::glDrawArraysInstanced, mode, first, count,
          instancecount);
 }
@@ -1247,6 +1500,8 @@ inline void glDrawElementsInstanced(
     GLenum mode, GLsizei count, GLenum type, void const *indices,
     GLsizei instancecount,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countInstancedDraw(mode, count, instancecount,
+                                                   true);
   callGL(sourceLocation, ::glDrawElementsInstanced, mode, count, type, indices,
          instancecount);
 }
@@ -1312,6 +1567,7 @@ inline GLboolean glIsSampler(
 inline void glBindSampler(
     GLuint unit, GLuint sampler,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glBindSampler, unit, sampler);
 }
 inline void glSamplerParameteri(
@@ -1347,11 +1603,13 @@ inline void glGetSamplerParameterfv(
 inline void glVertexAttribDivisor(
     GLuint index, GLuint divisor,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glVertexAttribDivisor, index, divisor);
 }
 inline void glBindTransformFeedback(
     GLenum target, GLuint id,
     source_location const &sourceLocation = source_location::current()) {
+  OpenGLCallStats::getInstance().countStateChange();
   callGL(sourceLocation, ::glBindTransformFeedback, target, id);
 }
 inline void glDeleteTransformFeedbacks(
@@ -1479,10 +1737,55 @@ inline void glGetDoublev(
   callGL(sourceLocation, ::glGetDoublev, pname, params);
 }
 #endif
+
+#if !defined(__EMSCRIPTEN__)
+
+// OpenGL 3.3+ function definitions
+
+inline void glQueryCounter(
+    GLuint id, GLenum target,
+    source_location const &sourceLocation = source_location::current()) {
+  callGL(sourceLocation, ::glQueryCounter, id, target);
+}
+inline void glGetQueryObjectui64v(
+    GLuint id, GLenum pname, GLuint64 *params,
+    source_location const &sourceLocation = source_location::current()) {
+  callGL(sourceLocation, ::glGetQueryObjectui64v, id, pname, params);
+}
+#endif
 // NOLINTEND(readability-identifier-length)
 
 } // namespace abcg
 
+/**
+ * @brief Marks a scope in which every call of the OpenGL error checking
+ * wrappers is checked, whatever the policy set with abcg::setGLCheckPolicy.
+ *
+ * Use it to check critical code when the policy is
+ * abcg::OpenGLCheckPolicy::MarkedRegions:
+ * @code
+ * {
+ *   abcg::OpenGLCheckRegion const checkRegion;
+ *   abcg::glBindVertexArray(m_VAO);
+ *   abcg::glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+ * }
+ * @endcode
+ *
+ * This has no effect in release builds.
+ */
+class abcg::OpenGLCheckRegion {
+public:
+#if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+  OpenGLCheckRegion() noexcept { ++detail::glCheckRegionDepth; }
+  ~OpenGLCheckRegion() { --detail::glCheckRegionDepth; }
+#else
+  // NOLINTNEXTLINE(modernize-use-equals-default)
+  OpenGLCheckRegion() noexcept {}
+#endif
+  OpenGLCheckRegion(OpenGLCheckRegion const &) = delete;
+  OpenGLCheckRegion &operator=(OpenGLCheckRegion const &) = delete;
+};
+
 #if defined(_MSC_VER)
 #pragma warning(pop)
 #endif
@@ -0,0 +1,214 @@
+/**
+ * @file abcgOpenGLGPUProfiler.cpp
+ * @brief Definition of abcg::OpenGLGPUProfiler and abcg::OpenGLGPUZone
+ * members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLGPUProfiler.hpp"
+
+#include "abcgOpenGLFunction.hpp"
+
+/**
+ * @brief Returns the GPU profiler instance.
+ */
+abcg::OpenGLGPUProfiler &abcg::OpenGLGPUProfiler::getInstance() {
+  static OpenGLGPUProfiler profiler;
+  return profiler;
+}
+
+/**
+ * @brief Checks for timestamp query support in the current OpenGL context.
+ *
+ * This is called by abcg::OpenGLWindow after the OpenGL context is created.
+ */
+void abcg::OpenGLGPUProfiler::create() {
+#if defined(__EMSCRIPTEN__)
+  m_supported = false;
+#else
+  m_supported = GLEW_ARB_timer_query != 0U;
+#endif
+  m_currentFrame = 0;
+  m_depth = 0;
+  m_recording = false;
+}
+
+/**
+ * @brief Releases the query objects.
+ *
+ * This is called by abcg::OpenGLWindow before the OpenGL context is
+ * destroyed.
+ */
+void abcg::OpenGLGPUProfiler::destroy() {
+  for (auto &frame : m_frames) {
+    if (!frame.queries.empty()) {
+      abcg::glDeleteQueries(gsl::narrow<GLsizei>(frame.queries.size()),
+                            frame.queries.data());
+    }
+    frame = {};
+  }
+  m_supported = false;
+  m_recording = false;
+}
+
+/**
+ * @brief Starts recording the GPU zones of the current frame of
+ * abcg::Profiler.
+ *
+ * The results of the oldest pending frame are read if they are available. If
+ * they are not, no zone is recorded in the current frame, so the pool is never
+ * waited on.
+ */
+void abcg::OpenGLGPUProfiler::beginFrame() {
+  m_recording = false;
+#if !defined(__EMSCRIPTEN__)
+  auto &profiler{Profiler::getInstance()};
+  if (!m_supported || !profiler.isEnabled())
+    return;
+
+  auto &frame{m_frames.at(m_currentFrame)};
+  if (frame.pending && !resolve(frame))
+    return;
+
+  // Relate the GPU clock to the profiler clock
+  GLint64 gpuTime{};
+  abcg::glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+  frame.timeOffset = profiler.now() - gsl::narrow_cast<double>(gpuTime) * 1e-9;
+
+  frame.frameNumber = profiler.getCurrentFrameNumber();
+  frame.usedQueries = 0;
+  frame.zones.clear();
+  m_depth = 0;
+  m_recording = true;
+#endif
+}
+
+/**
+ * @brief Stops recording the GPU zones of the current frame.
+ */
+void abcg::OpenGLGPUProfiler::endFrame() {
+  if (!m_recording)
+    return;
+
+  auto &frame{m_frames.at(m_currentFrame)};
+  frame.pending = !frame.zones.empty();
+  m_currentFrame = (m_currentFrame + 1) % framesInFlight;
+  m_recording = false;
+}
+
+/**
+ * @brief Opens a GPU zone.
+ *
+ * @param name Name of the zone. Must have static storage duration, such as a
+ * string literal.
+ *
+ * @return Index to be passed to abcg::OpenGLGPUProfiler::endZone.
+ */
+std::size_t abcg::OpenGLGPUProfiler::beginZone(char const *name) {
+  if (!m_recording)
+    return SIZE_MAX;
+
+#if defined(__EMSCRIPTEN__)
+  return SIZE_MAX;
+#else
+  auto &frame{m_frames.at(m_currentFrame)};
+  auto const query{acquireQuery(frame)};
+  abcg::glQueryCounter(query, GL_TIMESTAMP);
+  frame.zones.push_back(
+      {.name = name, .depth = m_depth++, .beginQuery = query, .endQuery = 0});
+  return frame.zones.size() - 1;
+#endif
+}
+
+/**
+ * @brief Closes a GPU zone opened with abcg::OpenGLGPUProfiler::beginZone.
+ *
+ * @param zoneIndex Index returned by abcg::OpenGLGPUProfiler::beginZone.
+ */
+void abcg::OpenGLGPUProfiler::endZone(std::size_t zoneIndex) {
+  if (!m_recording || zoneIndex == SIZE_MAX)
+    return;
+
+#if !defined(__EMSCRIPTEN__)
+  auto &frame{m_frames.at(m_currentFrame)};
+  auto const query{acquireQuery(frame)};
+  abcg::glQueryCounter(query, GL_TIMESTAMP);
+  frame.zones.at(zoneIndex).endQuery = query;
+  --m_depth;
+#endif
+}
+
+/**
+ * @brief Returns whether timestamp queries are supported by the current
+ * OpenGL context.
+ */
+bool abcg::OpenGLGPUProfiler::isSupported() const noexcept {
+  return m_supported;
+}
+
+GLuint abcg::OpenGLGPUProfiler::acquireQuery(FrameQueries &frame) {
+  if (frame.usedQueries == frame.queries.size()) {
+    GLuint query{};
+    abcg::glGenQueries(1, &query);
+    frame.queries.push_back(query);
+  }
+  return frame.queries.at(frame.usedQueries++);
+}
+
+// Reads the query results of a frame and passes them to the profiler. Returns
+// false without reading anything if the results are not available yet
+bool abcg::OpenGLGPUProfiler::resolve(FrameQueries &frame) {
+#if defined(__EMSCRIPTEN__)
+  return true;
+#else
+  // Queries complete in order, so the last one is checked first
+  GLuint available{};
+  abcg::glGetQueryObjectuiv(frame.queries.at(frame.usedQueries - 1),
+                            GL_QUERY_RESULT_AVAILABLE, &available);
+  if (available == GL_FALSE)
+    return false;
+
+  auto const toProfilerTime{[&frame](GLuint query) {
+    GLuint64 gpuTime{};
+    abcg::glGetQueryObjectui64v(query, GL_QUERY_RESULT, &gpuTime);
+    return gsl::narrow_cast<double>(gpuTime) * 1e-9 + frame.timeOffset;
+  }};
+
+  std::vector<ProfilerZoneRecord> records;
+  records.reserve(frame.zones.size());
+  for (auto const &zone : frame.zones) {
+    // Skip zones that were not closed
+    if (zone.endQuery == 0)
+      continue;
+    records.push_back({.name = zone.name,
+                       .start = toProfilerTime(zone.beginQuery),
+                       .end = toProfilerTime(zone.endQuery),
+                       .depth = zone.depth,
+                       .thread = 0});
+  }
+  Profiler::getInstance().setGPUZones(frame.frameNumber, std::move(records));
+
+  frame.pending = false;
+  return true;
+#endif
+}
+
+/**
+ * @brief Opens a GPU zone in abcg::OpenGLGPUProfiler.
+ *
+ * @param name Name of the zone. Must have static storage duration, such as a
+ * string literal.
+ */
+abcg::OpenGLGPUZone::OpenGLGPUZone(char const *name)
+    : m_zoneIndex{OpenGLGPUProfiler::getInstance().beginZone(name)} {}
+
+/**
+ * @brief Closes the GPU zone.
+ */
+abcg::OpenGLGPUZone::~OpenGLGPUZone() {
+  OpenGLGPUProfiler::getInstance().endZone(m_zoneIndex);
+}
@@ -0,0 +1,126 @@
+/**
+ * @file abcgOpenGLGPUProfiler.hpp
+ * @brief Header file of abcg::OpenGLGPUProfiler.
+ *
+ * Declaration of abcg::OpenGLGPUProfiler and abcg::OpenGLGPUZone classes, and
+ * of the ABCG_GPU_ZONE macro.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_GPU_PROFILER_HPP_
+#define ABCG_OPENGL_GPU_PROFILER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "abcgOpenGLExternal.hpp"
+#include "abcgProfiler.hpp"
+
+namespace abcg {
+class OpenGLGPUProfiler;
+class OpenGLGPUZone;
+} // namespace abcg
+
+/**
+ * @brief Profiles the GPU time of the OpenGL commands issued in the enclosing
+ * scope, as a zone of the given name.
+ *
+ * @param name String literal with the name of the zone.
+ */
+#define ABCG_GPU_ZONE(name)                                                    \
+  abcg::OpenGLGPUZone const ABCG_PROFILE_CONCAT(abcgGPUZone, __LINE__) {       \
+    name                                                                       \
+  }
+
+/**
+ * @brief Measures the GPU time of OpenGL commands with timestamp queries.
+ *
+ * Zones are delimited by `GL_TIMESTAMP` queries taken from a pool of queries
+ * for each of the last abcg::OpenGLGPUProfiler::framesInFlight frames. The
+ * results of a frame are read only when they are available, a few frames
+ * later, so reading them never stalls the pipeline. The timings are converted
+ * to the time base of abcg::Profiler and stored in
+ * abcg::ProfilerFrame::gpuZones.
+ *
+ * abcg::OpenGLWindow records GPU zones around abcg::OpenGLWindow::onPaint and
+ * the rendering of the UI. Custom zones can be recorded in
+ * abcg::OpenGLWindow::onPaint with the ABCG_GPU_ZONE macro.
+ *
+ * @remark GPU zones must be recorded in the thread of the OpenGL context.
+ * Timestamp queries require OpenGL 3.3 or ARB_timer_query, and are not
+ * supported in OpenGL ES and WebGL.
+ */
+class abcg::OpenGLGPUProfiler {
+public:
+  /** @brief Number of frames whose queries can be pending at once. */
+  static constexpr std::size_t framesInFlight{4};
+
+  static OpenGLGPUProfiler &getInstance();
+
+  void create();
+  void destroy();
+
+  void beginFrame();
+  void endFrame();
+
+  [[nodiscard]] std::size_t beginZone(char const *name);
+  void endZone(std::size_t zoneIndex);
+
+  [[nodiscard]] bool isSupported() const noexcept;
+
+private:
+  OpenGLGPUProfiler() = default;
+
+  struct Zone {
+    char const *name{};
+    std::uint32_t depth{};
+    GLuint beginQuery{};
+    GLuint endQuery{};
+  };
+
+  struct FrameQueries {
+    std::uint64_t frameNumber{};
+    // Profiler time minus GPU time, in seconds
+    double timeOffset{};
+    std::vector<GLuint> queries;
+    std::size_t usedQueries{};
+    std::vector<Zone> zones;
+    bool pending{};
+  };
+
+  GLuint acquireQuery(FrameQueries &frame);
+  bool resolve(FrameQueries &frame);
+
+  std::array<FrameQueries, framesInFlight> m_frames{};
+  std::size_t m_currentFrame{};
+  std::uint32_t m_depth{};
+  bool m_supported{};
+  bool m_recording{};
+};
+
+/**
+ * @brief Records a GPU zone in abcg::OpenGLGPUProfiler during the lifetime of
+ * the object.
+ *
+ * @remark Objects of this type cannot be copied or moved.
+ */
+class abcg::OpenGLGPUZone {
+public:
+  explicit OpenGLGPUZone(char const *name);
+  OpenGLGPUZone(OpenGLGPUZone const &) = delete;
+  OpenGLGPUZone(OpenGLGPUZone &&) = delete;
+  OpenGLGPUZone &operator=(OpenGLGPUZone const &) = delete;
+  OpenGLGPUZone &operator=(OpenGLGPUZone &&) = delete;
+  ~OpenGLGPUZone();
+
+private:
+  std::size_t m_zoneIndex;
+};
+
+#endif
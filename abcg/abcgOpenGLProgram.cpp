@@ -0,0 +1,361 @@
+/**
+ * @file abcgOpenGLProgram.cpp
+ * @brief Definition of abcg::OpenGLProgram members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLProgram.hpp"
+
+#include <utility>
+
+#include "abcgException.hpp"
+#include "abcgShaderSourceCache.hpp"
+
+namespace {
+// Watches the shader files and the files they include
+void watchShaderFiles(abcg::FileWatcher &watcher,
+                      std::vector<abcg::ShaderSource> const &pathsOrSources) {
+  auto &cache{abcg::ShaderSourceCache::getInstance()};
+  for (auto const &pathOrSource : pathsOrSources) {
+    if (!watcher.watch(pathOrSource.source))
+      continue;
+    for (auto const &dependency : cache.getDependencies(pathOrSource.source)) {
+      watcher.watch(dependency);
+    }
+  }
+}
+} // namespace
+
+/**
+ * @brief Creates the object from a program object and enumerates its active
+ * uniform and attribute variables.
+ *
+ * Elements of uniform arrays are found by their names with the subscript
+ * (e.g., `lights[1]`). The first element is also found by the name of the
+ * array without subscript.
+ *
+ * @param program ID of a linked program object, as returned by
+ * abcg::createOpenGLProgram.
+ *
+ * @throw abcg::RuntimeError if the hashes of two variable names collide.
+ */
+abcg::OpenGLProgram::OpenGLProgram(GLuint const program) : m_program{program} {
+  reflect();
+}
+
+/**
+ * @brief Deletes the program object.
+ */
+void abcg::OpenGLProgram::destroy() {
+  cancelHotReload();
+  m_hotReload.reset();
+  glDeleteProgram(m_program);
+  m_program = 0;
+  m_uniforms.clear();
+  m_uniformHandles.clear();
+  m_attributeLocations.clear();
+}
+
+/**
+ * @brief Installs the program as part of the current rendering state.
+ */
+void abcg::OpenGLProgram::use() const { glUseProgram(m_program); }
+
+/**
+ * @brief Forgets the values set to the uniform variables.
+ *
+ * The next call to abcg::OpenGLProgram::setUniform for each variable is not
+ * skipped.
+ */
+void abcg::OpenGLProgram::invalidateUniforms() noexcept {
+  for (auto &uniform : m_uniforms) {
+    uniform.hasValue = false;
+  }
+}
+
+/**
+ * @brief Starts watching the shader files of the program.
+ *
+ * When any of the files changes, abcg::OpenGLProgram::updateHotReload
+ * rebuilds the program from the files without blocking and replaces the
+ * program object only if the build succeeds.
+ *
+ * @param pathsOrSources Paths or source codes of the shaders, as passed to
+ * abcg::createOpenGLProgram. Only the paths and the files they include are
+ * watched.
+ */
+void abcg::OpenGLProgram::enableHotReload(
+    std::vector<ShaderSource> const &pathsOrSources) {
+  cancelHotReload();
+  m_hotReload = std::make_unique<HotReload>();
+  m_hotReload->pathsOrSources = pathsOrSources;
+  watchShaderFiles(m_hotReload->watcher, pathsOrSources);
+}
+
+/**
+ * @brief Advances the rebuild of the program from its shader files.
+ *
+ * This function must be called regularly (e.g., once per frame) after
+ * abcg::OpenGLProgram::enableHotReload. It does not wait for the compilation
+ * or linking of the shaders: the build is triggered when a file changes and
+ * checked on later calls with abcg::isOpenGLShaderCompileComplete and
+ * abcg::isOpenGLShaderLinkComplete. A build is restarted if a file changes
+ * again before it finishes.
+ *
+ * If the build succeeds, the previous program object is deleted and the new
+ * one takes its place. Uniform variables are reflected again and must be set
+ * again. If the build fails, the information log is printed and the previous
+ * program is kept.
+ *
+ * @remark This function makes OpenGL calls and must be called on the thread
+ * of the OpenGL context (e.g., in abcg::OpenGLWindow::onPaint), not in
+ * abcg::OpenGLWindow::onUpdate, which may run on a worker thread if
+ * abcg::WindowSettings::pipelinedUpdate is enabled.
+ *
+ * @return `true` if the program object was replaced; `false` otherwise.
+ */
+bool abcg::OpenGLProgram::updateHotReload() {
+  if (!m_hotReload)
+    return false;
+  auto &hotReload{*m_hotReload};
+
+  try {
+    if (auto const changedFiles{hotReload.watcher.poll()};
+        !changedFiles.empty()) {
+      for (auto const &file : changedFiles) {
+        ShaderSourceCache::getInstance().invalidate(file);
+      }
+      cancelHotReload();
+      hotReload.shaders = triggerOpenGLShaderCompile(hotReload.pathsOrSources);
+      // Watch the files that are now included
+      watchShaderFiles(hotReload.watcher, hotReload.pathsOrSources);
+      return false;
+    }
+
+    if (!hotReload.shaders.empty()) {
+      if (!isOpenGLShaderCompileComplete(hotReload.shaders))
+        return false;
+      auto const shaders{std::exchange(hotReload.shaders, {})};
+      checkOpenGLShaderCompile(shaders);
+      hotReload.program = triggerOpenGLShaderLink(shaders);
+      return false;
+    }
+
+    if (hotReload.program == 0 ||
+        !isOpenGLShaderLinkComplete(hotReload.program))
+      return false;
+    auto const program{std::exchange(hotReload.program, 0U)};
+    checkOpenGLShaderLink(program);
+
+    glDeleteProgram(m_program);
+    m_program = program;
+    reflect();
+    return true;
+  } catch (abcg::RuntimeError const &exception) {
+    fmt::print("Failed to reload program: {}\n", exception.what());
+    return false;
+  }
+}
+
+// Enumerates the active uniform and attribute variables
+void abcg::OpenGLProgram::reflect() {
+  m_uniforms.clear();
+  m_uniformHandles.clear();
+  m_attributeLocations.clear();
+  if (m_program == 0)
+    return;
+
+  GLint numUniforms{};
+  GLint maxUniformLength{};
+  glGetProgramiv(m_program, GL_ACTIVE_UNIFORMS, &numUniforms);
+  glGetProgramiv(m_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxUniformLength);
+  std::vector<GLchar> name(gsl::narrow<std::size_t>(maxUniformLength) + 1);
+
+  for (auto const index : iter::range(gsl::narrow<GLuint>(numUniforms))) {
+    GLsizei length{};
+    GLint size{};
+    GLenum type{};
+    glGetActiveUniform(m_program, index, gsl::narrow<GLsizei>(name.size()),
+                       &length, &size, &type, name.data());
+    std::string uniformName{name.data(), gsl::narrow<std::size_t>(length)};
+
+    // Names of arrays are reported with the subscript of the first element
+    if (uniformName.ends_with("[0]")) {
+      auto const baseName{uniformName.substr(0, uniformName.size() - 3)};
+      auto const firstHandle{addUniform(uniformName, type)};
+      for (auto const element : iter::range(1, size)) {
+        addUniform(fmt::format("{}[{}]", baseName, element), type);
+      }
+      if (firstHandle != invalidHandle) {
+        addHandle(baseName, firstHandle);
+      }
+    } else {
+      addUniform(uniformName, type);
+    }
+  }
+
+  GLint numAttributes{};
+  GLint maxAttributeLength{};
+  glGetProgramiv(m_program, GL_ACTIVE_ATTRIBUTES, &numAttributes);
+  glGetProgramiv(m_program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH,
+                 &maxAttributeLength);
+  name.resize(gsl::narrow<std::size_t>(maxAttributeLength) + 1);
+
+  for (auto const index : iter::range(gsl::narrow<GLuint>(numAttributes))) {
+    GLsizei length{};
+    GLint size{};
+    GLenum type{};
+    glGetActiveAttrib(m_program, index, gsl::narrow<GLsizei>(name.size()),
+                      &length, &size, &type, name.data());
+    std::string const attributeName{name.data(),
+                                    gsl::narrow<std::size_t>(length)};
+    auto const location{glGetAttribLocation(m_program, attributeName.c_str())};
+    if (!m_attributeLocations.try_emplace(NameHash::hash(attributeName),
+                                          location)
+             .second) {
+      throw abcg::RuntimeError(fmt::format(
+          "Hash of attribute name {} collides with another name",
+          attributeName));
+    }
+  }
+}
+
+/**
+ * @brief Returns the handle of a uniform variable.
+ *
+ * @param name Hash of the name of the uniform variable.
+ *
+ * @returns Handle of the uniform variable, or
+ * abcg::OpenGLProgram::invalidHandle if the variable is not active.
+ */
+abcg::OpenGLProgram::UniformHandle
+abcg::OpenGLProgram::getUniformHandle(NameHash const name) const {
+  auto const iter{m_uniformHandles.find(name.value)};
+  return iter == m_uniformHandles.end() ? invalidHandle : iter->second;
+}
+
+/**
+ * @brief Returns the location of a uniform variable.
+ *
+ * @param name Hash of the name of the uniform variable.
+ *
+ * @returns Location of the uniform variable, or -1 if the variable is not
+ * active.
+ */
+GLint abcg::OpenGLProgram::getUniformLocation(NameHash const name) const {
+  auto const handle{getUniformHandle(name)};
+  return handle == invalidHandle ? -1 : m_uniforms[handle].location;
+}
+
+/**
+ * @brief Returns the location of an attribute variable.
+ *
+ * @param name Hash of the name of the attribute variable.
+ *
+ * @returns Location of the attribute variable, or -1 if the variable is not
+ * active.
+ */
+GLint abcg::OpenGLProgram::getAttributeLocation(NameHash const name) const {
+  auto const iter{m_attributeLocations.find(name.value)};
+  return iter == m_attributeLocations.end() ? -1 : iter->second;
+}
+
+// Deletes the shaders or program of the rebuild in progress, if any
+void abcg::OpenGLProgram::cancelHotReload() {
+  if (!m_hotReload)
+    return;
+  for (auto const &shader : std::exchange(m_hotReload->shaders, {})) {
+    glDeleteShader(shader.shader);
+  }
+  glDeleteProgram(std::exchange(m_hotReload->program, 0U));
+}
+
+abcg::OpenGLProgram::UniformHandle
+abcg::OpenGLProgram::addUniform(std::string name, GLenum const type) {
+  auto const location{glGetUniformLocation(m_program, name.c_str())};
+  // Variables of uniform blocks have no location
+  if (location < 0)
+    return invalidHandle;
+
+  auto const handle{gsl::narrow<UniformHandle>(m_uniforms.size())};
+  addHandle(name, handle);
+  m_uniforms.push_back({.name = std::move(name),
+                        .location = location,
+                        .type = type,
+                        .value = {},
+                        .hasValue = false});
+  return handle;
+}
+
+void abcg::OpenGLProgram::addHandle(std::string_view name,
+                                    UniformHandle const handle) {
+  if (!m_uniformHandles.try_emplace(NameHash::hash(name), handle).second) {
+    throw abcg::RuntimeError(fmt::format(
+        "Hash of uniform name {} collides with another name", name));
+  }
+}
+
+void abcg::OpenGLProgram::upload(GLint const location, bool const value) {
+  glUniform1i(location, value ? 1 : 0);
+}
+
+void abcg::OpenGLProgram::upload(GLint const location, int const value) {
+  glUniform1i(location, value);
+}
+
+void abcg::OpenGLProgram::upload(GLint const location, unsigned const value) {
+  glUniform1ui(location, value);
+}
+
+void abcg::OpenGLProgram::upload(GLint const location, float const value) {
+  glUniform1f(location, value);
+}
+
+void abcg::OpenGLProgram::upload(GLint const location,
+                                 glm::vec2 const &value) {
+  glUniform2fv(location, 1, &value.x);
+}
+
+void abcg::OpenGLProgram::upload(GLint const location,
+                                 glm::vec3 const &value) {
+  glUniform3fv(location, 1, &value.x);
+}
+
+void abcg::OpenGLProgram::upload(GLint const location,
+                                 glm::vec4 const &value) {
+  glUniform4fv(location, 1, &value.x);
+}
+
+void abcg::OpenGLProgram::upload(GLint const location,
+                                 glm::ivec2 const &value) {
+  glUniform2iv(location, 1, &value.x);
+}
+
+void abcg::OpenGLProgram::upload(GLint const location,
+                                 glm::ivec3 const &value) {
+  glUniform3iv(location, 1, &value.x);
+}
+
+void abcg::OpenGLProgram::upload(GLint const location,
+                                 glm::ivec4 const &value) {
+  glUniform4iv(location, 1, &value.x);
+}
+
+void abcg::OpenGLProgram::upload(GLint const location,
+                                 glm::mat2 const &value) {
+  glUniformMatrix2fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+void abcg::OpenGLProgram::upload(GLint const location,
+                                 glm::mat3 const &value) {
+  glUniformMatrix3fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+void abcg::OpenGLProgram::upload(GLint const location,
+                                 glm::mat4 const &value) {
+  glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]);
+}
@@ -0,0 +1,221 @@
+/**
+ * @file abcgOpenGLProgram.hpp
+ * @brief Header file of abcg::OpenGLProgram.
+ *
+ * Declaration of abcg::OpenGLProgram class and abcg::NameHash structure.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_PROGRAM_HPP_
+#define ABCG_OPENGL_PROGRAM_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "abcgExternal.hpp"
+#include "abcgFileWatcher.hpp"
+#include "abcgOpenGLFunction.hpp"
+#include "abcgOpenGLShader.hpp"
+#include "abcgShader.hpp"
+
+namespace abcg {
+struct NameHash;
+class OpenGLProgram;
+} // namespace abcg
+
+/**
+ * @brief 64-bit FNV-1a hash of the name of a uniform or attribute variable.
+ *
+ * Hashes of string literals are computed at compile time:
+ * @code
+ * program.setUniform("viewMatrix", viewMatrix);
+ * @endcode
+ * Hashes of other strings must be created explicitly:
+ * @code
+ * program.setUniform(abcg::NameHash{name}, value);
+ * @endcode
+ */
+struct abcg::NameHash {
+  /** @brief Hash value. */
+  std::uint64_t value{};
+
+  /**
+   * @brief Hashes a string literal at compile time.
+   *
+   * @param name Variable name.
+   */
+  template <std::size_t N>
+  // NOLINTNEXTLINE(*-avoid-c-arrays, google-explicit-constructor)
+  consteval NameHash(char const (&name)[N])
+      : value{hash(std::string_view{name, N - 1})} {}
+
+  /**
+   * @brief Hashes a string.
+   *
+   * @param name Variable name.
+   */
+  constexpr explicit NameHash(std::string_view name) : value{hash(name)} {}
+
+  /**
+   * @brief Computes the hash of a string.
+   *
+   * @param name String to be hashed.
+   *
+   * @returns 64-bit FNV-1a hash.
+   */
+  [[nodiscard]] static constexpr std::uint64_t
+  hash(std::string_view name) noexcept {
+    std::uint64_t result{0xcbf29ce484222325};
+    for (auto const character : name) {
+      result ^= static_cast<std::uint8_t>(character);
+      result *= 0x100000001b3;
+    }
+    return result;
+  }
+};
+
+/**
+ * @brief OpenGL program object with reflected uniform and attribute
+ * variables.
+ *
+ * The active uniform and attribute variables are enumerated once, when the
+ * object is created, and are found by the hash of their names. Each uniform
+ * variable also has a handle, which is an index to an array.
+ *
+ * The setters keep a copy of the last value set to each uniform variable and
+ * skip the `glUniform*` calls that would not change it. Values set without
+ * the setters (e.g., with `abcg::glUniform1f`) are not tracked. Call
+ * abcg::OpenGLProgram::invalidateUniforms after such calls.
+ *
+ * The program can be rebuilt when its shader files change. See
+ * abcg::OpenGLProgram::enableHotReload.
+ *
+ * The object does not own the program. It must be deleted with
+ * abcg::OpenGLProgram::destroy while the OpenGL context is current.
+ */
+class abcg::OpenGLProgram {
+public:
+  /** @brief Index of a uniform variable. */
+  using UniformHandle = std::uint32_t;
+  /** @brief Handle of uniform variables that are not active. */
+  static constexpr UniformHandle invalidHandle{
+      std::numeric_limits<UniformHandle>::max()};
+
+  OpenGLProgram() = default;
+  explicit OpenGLProgram(GLuint program);
+
+  void destroy();
+  void use() const;
+  void invalidateUniforms() noexcept;
+
+  void enableHotReload(std::vector<ShaderSource> const &pathsOrSources);
+  bool updateHotReload();
+
+  /** @brief Returns the ID of the program object. */
+  [[nodiscard]] GLuint getID() const noexcept { return m_program; }
+
+  [[nodiscard]] UniformHandle getUniformHandle(NameHash name) const;
+  [[nodiscard]] GLint getUniformLocation(NameHash name) const;
+  [[nodiscard]] GLint getAttributeLocation(NameHash name) const;
+
+  template <typename T> void setUniform(UniformHandle handle, T const &value);
+  template <typename T> void setUniform(NameHash name, T const &value);
+
+private:
+  struct Uniform {
+    std::string name;
+    GLint location{-1};
+    GLenum type{};
+    // Last value set, valid if hasValue is true
+    std::array<std::byte, sizeof(glm::mat4)> value{};
+    bool hasValue{};
+  };
+
+  // State of the rebuild of the program from its shader files
+  struct HotReload {
+    std::vector<ShaderSource> pathsOrSources;
+    FileWatcher watcher;
+    // Shaders being compiled, if any
+    std::vector<OpenGLShader> shaders;
+    // Program being linked, if any
+    GLuint program{};
+  };
+
+  void reflect();
+  void cancelHotReload();
+  UniformHandle addUniform(std::string name, GLenum type);
+  void addHandle(std::string_view name, UniformHandle handle);
+
+  static void upload(GLint location, bool value);
+  static void upload(GLint location, int value);
+  static void upload(GLint location, unsigned value);
+  static void upload(GLint location, float value);
+  static void upload(GLint location, glm::vec2 const &value);
+  static void upload(GLint location, glm::vec3 const &value);
+  static void upload(GLint location, glm::vec4 const &value);
+  static void upload(GLint location, glm::ivec2 const &value);
+  static void upload(GLint location, glm::ivec3 const &value);
+  static void upload(GLint location, glm::ivec4 const &value);
+  static void upload(GLint location, glm::mat2 const &value);
+  static void upload(GLint location, glm::mat3 const &value);
+  static void upload(GLint location, glm::mat4 const &value);
+
+  GLuint m_program{};
+  std::vector<Uniform> m_uniforms;
+  std::unordered_map<std::uint64_t, UniformHandle> m_uniformHandles;
+  std::unordered_map<std::uint64_t, GLint> m_attributeLocations;
+  std::unique_ptr<HotReload> m_hotReload;
+};
+
+/**
+ * @brief Sets the value of a uniform variable of the program.
+ *
+ * The program must be in use. The call is skipped if the value is equal to
+ * the last value set with this function.
+ *
+ * @param handle Handle of the uniform variable, as returned by
+ * abcg::OpenGLProgram::getUniformHandle. Invalid handles are ignored, as are
+ * locations of inactive variables in OpenGL.
+ * @param value New value.
+ */
+template <typename T>
+void abcg::OpenGLProgram::setUniform(UniformHandle const handle,
+                                     T const &value) {
+  static_assert(sizeof(T) <= sizeof(Uniform::value));
+  if (handle >= m_uniforms.size())
+    return;
+  auto &uniform{m_uniforms[handle]};
+  if (uniform.hasValue &&
+      std::memcmp(uniform.value.data(), &value, sizeof(T)) == 0)
+    return;
+  std::memcpy(uniform.value.data(), &value, sizeof(T));
+  uniform.hasValue = true;
+  upload(uniform.location, value);
+}
+
+/**
+ * @brief Sets the value of a uniform variable of the program.
+ *
+ * @param name Hash of the name of the uniform variable.
+ * @param value New value.
+ *
+ * @sa abcg::OpenGLProgram::setUniform(UniformHandle, T const &).
+ */
+template <typename T>
+void abcg::OpenGLProgram::setUniform(NameHash const name, T const &value) {
+  setUniform(getUniformHandle(name), value);
+}
+
+#endif
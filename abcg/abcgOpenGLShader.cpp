@@ -14,12 +14,20 @@
 #include <fmt/core.h>
 #include <gsl/gsl>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
-#include <sstream>
+#include <memory>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "abcgException.hpp"
+#include "abcgOpenGLFrameUniforms.hpp"
+#include "abcgShaderSourceCache.hpp"
+#include "abcgUtil.hpp"
 
 namespace {
 void printShaderInfoLog(GLuint const shader, std::string_view prefix) {
@@ -76,23 +84,29 @@ void printProgramInfoLog(GLuint const program) {
   }
 }
 
+// Source code of a shader, shared with abcg::ShaderSourceCache
+struct LoadedShaderSource {
+  std::shared_ptr<std::string const> source;
+  abcg::ShaderStage stage{};
+};
+
 // If filenameOrText is a filename, returns the contents of the file (assumed
-// to be in text format). Otherwise, returns filenameOrText.
-[[nodiscard]] std::string toSource(std::string_view filenameOrText) {
-  static const std::size_t maxPathSize{260};
-  if (filenameOrText.size() > maxPathSize ||
-      !std::filesystem::exists(filenameOrText)) {
-    return filenameOrText.data();
-  }
-  std::stringstream source;
-  if (std::ifstream stream(filenameOrText.data()); stream) {
-    source << stream.rdbuf();
-    stream.close();
-  } else {
-    throw abcg::RuntimeError(
-        fmt::format("Failed to read file {}", filenameOrText));
+// to be in text format) with its includes resolved. Otherwise, returns
+// filenameOrText.
+[[nodiscard]] std::shared_ptr<std::string const>
+toSource(std::string_view filenameOrText) {
+  return abcg::ShaderSourceCache::getInstance().load(filenameOrText);
+}
+
+[[nodiscard]] std::vector<LoadedShaderSource>
+loadSources(std::vector<abcg::ShaderSource> const &pathsOrSources) {
+  std::vector<LoadedShaderSource> sources;
+  sources.reserve(pathsOrSources.size());
+  for (auto const &pathOrSource : pathsOrSources) {
+    sources.push_back(
+        {.source = toSource(pathOrSource.source), .stage = pathOrSource.stage});
   }
-  return source.str();
+  return sources;
 }
 
 // Compiles a shader and returns immediately (i.e. don't wait until completion).
@@ -101,7 +115,8 @@ void printProgramInfoLog(GLuint const program) {
                                                GLuint shaderStage) {
   auto shaderID{glCreateShader(shaderStage)};
   auto const *source{shaderSource.data()};
-  glShaderSource(shaderID, 1, &source, nullptr);
+  auto const length{gsl::narrow<GLint>(shaderSource.size())};
+  glShaderSource(shaderID, 1, &source, &length);
   glCompileShader(shaderID);
   return {shaderID, shaderStage};
 }
@@ -113,6 +128,223 @@ void deleteShaders(std::vector<abcg::OpenGLShader> const &shaderIDs) {
   }
 }
 
+// Directory of the program binary cache, or empty if the cache is disabled
+std::string programCacheDirectory; // NOLINT(*-avoid-non-const-global-variables)
+
+// Header of the files of the program binary cache
+struct ProgramBinaryHeader {
+  std::array<char, 8> magic{'A', 'B', 'C', 'G', 'P', 'R', 'G', 'B'};
+  std::uint32_t version{1};
+  GLenum format{};
+  std::uint64_t key{};
+  std::uint64_t length{};
+};
+
+[[nodiscard]] bool isProgramCacheEnabled() {
+#if defined(__EMSCRIPTEN__)
+  return false;
+#else
+  if (programCacheDirectory.empty() ||
+      (GLEW_VERSION_4_1 == 0U && GLEW_ARB_get_program_binary == 0U))
+    return false;
+  GLint numFormats{};
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+  return numFormats > 0;
+#endif
+}
+
+[[nodiscard]] std::string_view getGLString(GLenum const name) {
+  auto const *string{reinterpret_cast<char const *>(glGetString(name))};
+  return string == nullptr ? std::string_view{} : std::string_view{string};
+}
+
+// Hash of the shader sources and of the driver that compiles them
+[[nodiscard]] std::uint64_t
+programCacheKey(std::vector<LoadedShaderSource> const &sources) {
+  std::size_t seed{};
+  for (auto const &source : sources) {
+    abcg::hashCombineSeed(seed, std::string_view{*source.source},
+                          source.stage);
+  }
+  abcg::hashCombineSeed(seed, getGLString(GL_VENDOR), getGLString(GL_RENDERER),
+                        getGLString(GL_VERSION),
+                        getGLString(GL_SHADING_LANGUAGE_VERSION));
+  return seed;
+}
+
+[[nodiscard]] std::filesystem::path programCachePath(std::uint64_t const key) {
+  return std::filesystem::path{programCacheDirectory} /
+         fmt::format("{:016x}.bin", key);
+}
+
+// Creates a program from the cached binary. Returns 0 if there is no valid
+// binary for the key.
+[[nodiscard]] GLuint loadProgramBinary(std::uint64_t const key) {
+  auto const path{programCachePath(key)};
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream)
+    return 0;
+
+  ProgramBinaryHeader header;
+  ProgramBinaryHeader const expected{.key = key};
+  stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+  std::error_code errorCode;
+  auto const fileSize{std::filesystem::file_size(path, errorCode)};
+  if (!stream || errorCode || header.magic != expected.magic ||
+      header.version != expected.version || header.key != key ||
+      header.length != fileSize - sizeof(header)) {
+    return 0;
+  }
+
+  std::vector<char> binary(gsl::narrow<std::size_t>(header.length));
+  if (!stream.read(binary.data(), gsl::narrow<std::streamsize>(binary.size())))
+    return 0;
+
+  auto const program{glCreateProgram()};
+  glProgramBinary(program, header.format, binary.data(),
+                  gsl::narrow<GLsizei>(binary.size()));
+  GLint linkStatus{};
+  glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+  if (linkStatus == GL_FALSE) {
+    // The binary was rejected, e.g., after a driver update
+    glDeleteProgram(program);
+    stream.close();
+    std::filesystem::remove(path, errorCode);
+    return 0;
+  }
+  return program;
+}
+
+// Writes the binary of a linked program to the cache. Errors are ignored, as
+// the program is then compiled from the sources in the next run.
+void saveProgramBinary(GLuint const program, std::uint64_t const key) {
+  GLint length{};
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0)
+    return;
+
+  std::vector<char> binary(gsl::narrow<std::size_t>(length));
+  ProgramBinaryHeader header{.key = key};
+  GLsizei writtenLength{};
+  glGetProgramBinary(program, length, &writtenLength, &header.format,
+                     binary.data());
+  header.length = gsl::narrow<std::uint64_t>(writtenLength);
+
+  std::error_code errorCode;
+  std::filesystem::create_directories(programCacheDirectory, errorCode);
+  if (errorCode)
+    return;
+
+  // Write to a temporary file first so that a partially written binary is
+  // never read
+  auto const path{programCachePath(key)};
+  auto tempPath{path};
+  tempPath.replace_extension(".tmp");
+  {
+    std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    stream.write(binary.data(), writtenLength);
+    if (!stream) {
+      stream.close();
+      std::filesystem::remove(tempPath, errorCode);
+      return;
+    }
+  }
+  std::filesystem::rename(tempPath, path, errorCode);
+}
+
+[[nodiscard]] bool isParallelCompileSupported() {
+#if defined(__EMSCRIPTEN__)
+  return false;
+#else
+  return GLEW_KHR_parallel_shader_compile != 0U ||
+         GLEW_ARB_parallel_shader_compile != 0U;
+#endif
+}
+
+void setMaxShaderCompilerThreads() {
+#if !defined(__EMSCRIPTEN__)
+  // Let the driver choose the number of compiler threads
+  constexpr GLuint maxThreads{0xFFFFFFFF};
+  if (GLEW_KHR_parallel_shader_compile != 0U) {
+    glMaxShaderCompilerThreadsKHR(maxThreads);
+  } else {
+    glMaxShaderCompilerThreadsARB(maxThreads);
+  }
+#endif
+}
+
+[[nodiscard]] bool isCompileComplete([[maybe_unused]] GLuint const shader) {
+#if defined(__EMSCRIPTEN__)
+  return true;
+#else
+  GLint completionStatus{};
+  glGetShaderiv(shader, GL_COMPLETION_STATUS_KHR, &completionStatus);
+  return completionStatus == GL_TRUE;
+#endif
+}
+
+[[nodiscard]] bool isLinkComplete([[maybe_unused]] GLuint const program) {
+#if defined(__EMSCRIPTEN__)
+  return true;
+#else
+  GLint completionStatus{};
+  glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &completionStatus);
+  return completionStatus == GL_TRUE;
+#endif
+}
+
+// Program whose shaders are being compiled and linked
+struct PendingProgram {
+  // Index of the program in the batch
+  std::size_t index{};
+  std::uint64_t cacheKey{};
+  GLuint program{};
+  std::vector<abcg::OpenGLShader> shaders;
+};
+
+// Checks the compile and link status of a program whose link has completed.
+// Returns the program, or 0 on error.
+[[nodiscard]] GLuint finishProgram(PendingProgram &pending, bool useCache,
+                                   bool throwOnError) {
+  auto const program{std::exchange(pending.program, 0U)};
+  for (auto const &shader : pending.shaders) {
+    glDetachShader(program, shader.shader);
+  }
+
+  auto const compiled{std::ranges::all_of(
+      pending.shaders, [](abcg::OpenGLShader const &shader) {
+        GLint compileStatus{};
+        glGetShaderiv(shader.shader, GL_COMPILE_STATUS, &compileStatus);
+        return compileStatus == GL_TRUE;
+      })};
+  if (!compiled) {
+    glDeleteProgram(program);
+    // Prints the information log of the failed shader and deletes the shaders
+    auto const shaders{std::exchange(pending.shaders, {})};
+    abcg::checkOpenGLShaderCompile(shaders, throwOnError);
+    return 0U;
+  }
+  deleteShaders(std::exchange(pending.shaders, {}));
+
+  if (!abcg::checkOpenGLShaderLink(program, throwOnError))
+    return 0U;
+
+  if (useCache) {
+    saveProgramBinary(program, pending.cacheKey);
+  }
+  return program;
+}
+
+void bindFrameUniformBlock(GLuint const program) {
+  auto const blockIndex{glGetUniformBlockIndex(
+      program, abcg::OpenGLFrameUniforms::blockName)};
+  if (blockIndex != GL_INVALID_INDEX) {
+    glUniformBlockBinding(program, blockIndex,
+                          abcg::OpenGLFrameUniforms::bindingPoint);
+  }
+}
+
 [[nodiscard]] GLuint abcgStageToOpenGLStage(abcg::ShaderStage stage) {
   switch (stage) {
   case abcg::ShaderStage::Vertex:
@@ -146,6 +378,13 @@ void deleteShaders(std::vector<abcg::OpenGLShader> const &shaderIDs) {
 /**
  * @brief Creates a program object from a group of shader paths or source codes.
  *
+ * If the program binary cache is enabled with
+ * abcg::setOpenGLProgramCacheDirectory, the program is loaded from the cached
+ * binary of a previous run, if any. The cached binary is found by a hash of
+ * the shader sources and stages, and of the vendor, renderer, version and
+ * GLSL version strings of the driver. Otherwise, the program is compiled and
+ * linked, and its binary is saved to the cache.
+ *
  * @param pathsOrSources Paths or source codes of the shaders to be compiled and
  * linked to the program.
  * @param throwOnError Whether to throw exceptions on compile/link errors.
@@ -159,57 +398,139 @@ void deleteShaders(std::vector<abcg::OpenGLShader> const &shaderIDs) {
 GLuint
 abcg::createOpenGLProgram(std::vector<ShaderSource> const &pathsOrSources,
                           bool throwOnError) {
-  std::vector<ShaderSource> sources;
-  sources.reserve(pathsOrSources.size());
-  for (auto const &pathOrSource : pathsOrSources) {
-    sources.push_back(
-        {.source = toSource(pathOrSource.source), .stage = pathOrSource.stage});
-  }
+  return createOpenGLPrograms({pathsOrSources}, throwOnError).front();
+}
 
-  std::vector<OpenGLShader> compiledShaders;
-  compiledShaders.reserve(sources.size());
-  for (auto const &source : sources) {
-    compiledShaders.push_back(
-        compileHelper(source.source, abcgStageToOpenGLStage(source.stage)));
+/**
+ * @brief Creates program objects from groups of shader paths or source codes.
+ *
+ * The shaders of all programs are compiled and linked before any compile or
+ * link status is queried. If KHR_parallel_shader_compile or
+ * ARB_parallel_shader_compile is supported, the driver is allowed to use as
+ * many compiler threads as it wants, and the programs are finished in the
+ * order their links complete, as polled with `GL_COMPLETION_STATUS_KHR`.
+ *
+ * Programs found in the binary cache (see
+ * abcg::setOpenGLProgramCacheDirectory) are loaded from their binaries
+ * instead.
+ *
+ * @param pathsOrSources Paths or source codes of the shaders of each program.
+ * @param throwOnError Whether to throw exceptions on compile/link errors.
+ *
+ * @throw abcg::RuntimeError if a shader could not be read from file, or if a
+ * program could not be created, or if the compilation of any shader has
+ * failed, or if the linking of any program has failed. No program is returned
+ * in this case.
+ *
+ * @return IDs of the program objects, in the order of `pathsOrSources`. The
+ * ID of a program that could not be created is 0.
+ */
+std::vector<GLuint> abcg::createOpenGLPrograms(
+    std::vector<std::vector<ShaderSource>> const &pathsOrSources,
+    bool throwOnError) {
+  std::vector<std::vector<LoadedShaderSource>> sources;
+  sources.reserve(pathsOrSources.size());
+  for (auto const &programPathsOrSources : pathsOrSources) {
+    sources.push_back(loadSources(programPathsOrSources));
   }
 
-  if (!checkOpenGLShaderCompile(compiledShaders, throwOnError))
-    return 0U;
-
-  auto const shaderProgram{glCreateProgram()};
-  if (shaderProgram == 0) {
-    deleteShaders(compiledShaders);
-    if (throwOnError) {
-      throw abcg::RuntimeError("Failed to create program");
-    }
-    return 0;
+  auto const useCache{isProgramCacheEnabled()};
+  auto const parallelCompile{isParallelCompileSupported()};
+  if (parallelCompile) {
+    setMaxShaderCompilerThreads();
   }
 
-  for (auto const &shader : compiledShaders) {
-    glAttachShader(shaderProgram, shader.shader);
-  }
+  std::vector<GLuint> programs(sources.size());
+  std::vector<PendingProgram> pending;
+  pending.reserve(sources.size());
+
+  try {
+    // Trigger the compilation and linking of all programs not in the cache
+    for (auto &&[index, programSources] : iter::enumerate(sources)) {
+      auto const cacheKey{useCache ? programCacheKey(programSources) : 0};
+      if (useCache) {
+        programs.at(index) = loadProgramBinary(cacheKey);
+        if (programs.at(index) != 0) {
+          bindFrameUniformBlock(programs.at(index));
+          continue;
+        }
+      }
 
-  glLinkProgram(shaderProgram);
+      auto &program{pending.emplace_back(
+          PendingProgram{.index = index,
+                         .cacheKey = cacheKey,
+                         .program = 0,
+                         .shaders = {}})};
+      for (auto const &source : programSources) {
+        program.shaders.push_back(compileHelper(
+            *source.source, abcgStageToOpenGLStage(source.stage)));
+      }
 
-  for (auto const &shader : compiledShaders) {
-    glDetachShader(shaderProgram, shader.shader);
-    glDeleteShader(shader.shader);
-  }
+      program.program = glCreateProgram();
+      if (program.program == 0) {
+        if (throwOnError) {
+          throw abcg::RuntimeError("Failed to create program");
+        }
+        deleteShaders(program.shaders);
+        pending.pop_back();
+        continue;
+      }
+      for (auto const &shader : program.shaders) {
+        glAttachShader(program.program, shader.shader);
+      }
+#if !defined(__EMSCRIPTEN__)
+      if (useCache) {
+        glProgramParameteri(program.program,
+                            GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+      }
+#endif
+      glLinkProgram(program.program);
+    }
 
-  GLint linkStatus{};
-  glGetProgramiv(shaderProgram, GL_LINK_STATUS, &linkStatus);
-  if (linkStatus == GL_FALSE) {
-    if (throwOnError) {
-      fmt::print("\n");
-      printProgramInfoLog(shaderProgram);
-      glDeleteProgram(shaderProgram);
-      throw abcg::RuntimeError("Failed to link program");
+    // Finish the programs as their links complete
+    while (!pending.empty()) {
+      for (auto iter{pending.begin()}; iter != pending.end();) {
+        if (parallelCompile && !isLinkComplete(iter->program)) {
+          ++iter;
+          continue;
+        }
+        programs.at(iter->index) = finishProgram(*iter, useCache, throwOnError);
+        iter = pending.erase(iter);
+      }
+      if (!pending.empty()) {
+        std::this_thread::yield();
+      }
     }
-    glDeleteProgram(shaderProgram);
-    return 0U;
+  } catch (...) {
+    for (auto &program : pending) {
+      deleteShaders(program.shaders);
+      glDeleteProgram(program.program);
+    }
+    for (auto const program : programs) {
+      glDeleteProgram(program);
+    }
+    throw;
   }
 
-  return shaderProgram;
+  return programs;
+}
+
+/**
+ * @brief Sets the directory of the program binary cache used by
+ * abcg::createOpenGLProgram.
+ *
+ * abcg::OpenGLWindow sets it to the `cache` subdirectory of
+ * abcg::Application::getBasePath if abcg::OpenGLSettings::programBinaryCache
+ * is `true`. The directory is created when the first binary is saved.
+ *
+ * The cache requires OpenGL 4.1 or ARB_get_program_binary and is not
+ * supported in WebGL.
+ *
+ * @param directory Path to the cache directory. An empty path disables the
+ * cache.
+ */
+void abcg::setOpenGLProgramCacheDirectory(std::string_view directory) {
+  programCacheDirectory = directory;
 }
 
 /**
@@ -237,18 +558,13 @@ abcg::createOpenGLProgram(std::vector<ShaderSource> const &pathsOrSources,
  */
 std::vector<abcg::OpenGLShader> abcg::triggerOpenGLShaderCompile(
     std::vector<ShaderSource> const &pathsOrSources) {
-  std::vector<ShaderSource> sources;
-  sources.reserve(pathsOrSources.size());
-  for (auto const &pathOrSource : pathsOrSources) {
-    sources.push_back(
-        {.source = toSource(pathOrSource.source), .stage = pathOrSource.stage});
-  }
+  auto const sources{loadSources(pathsOrSources)};
 
   std::vector<OpenGLShader> compiledShaders;
   compiledShaders.reserve(sources.size());
   for (auto const &source : sources) {
-    compiledShaders.push_back(
-        compileHelper(source.source, abcgStageToOpenGLStage(source.stage)));
+    compiledShaders.push_back(compileHelper(
+        *source.source, abcgStageToOpenGLStage(source.stage)));
   }
 
   return compiledShaders;
@@ -338,6 +654,9 @@ GLuint abcg::triggerOpenGLShaderLink(std::vector<OpenGLShader> const &shaders,
  * This should be called after abcg::triggerOpenGLShaderLink. The function will
  * wait until all shaders are linked.
  *
+ * If the program links with success, its `FrameUniforms` block, if any, is
+ * bound to abcg::OpenGLFrameUniforms::bindingPoint.
+ *
  * @param shaderProgram ID of the shader program returned by
  * abcg::triggerOpenGLShaderLink.
  * @param throwOnError Whether to throw exceptions on link error.
@@ -360,5 +679,44 @@ bool abcg::checkOpenGLShaderLink(GLuint shaderProgram, bool throwOnError) {
     return false;
   }
 
+  bindFrameUniformBlock(shaderProgram);
   return true;
+}
+
+/**
+ * @brief Queries whether the compilation of shader objects has completed,
+ * without waiting for it.
+ *
+ * If KHR_parallel_shader_compile or ARB_parallel_shader_compile is not
+ * supported, the compilation is assumed to be complete.
+ *
+ * @param shaders Shader objects returned by abcg::triggerOpenGLShaderCompile.
+ *
+ * @return `true` if abcg::checkOpenGLShaderCompile would not wait for the
+ * compilation; `false` otherwise.
+ */
+bool abcg::isOpenGLShaderCompileComplete(
+    std::vector<OpenGLShader> const &shaders) {
+  if (!isParallelCompileSupported())
+    return true;
+  return std::ranges::all_of(shaders, [](OpenGLShader const &shader) {
+    return isCompileComplete(shader.shader);
+  });
+}
+
+/**
+ * @brief Queries whether the linking of a program object has completed,
+ * without waiting for it.
+ *
+ * If KHR_parallel_shader_compile or ARB_parallel_shader_compile is not
+ * supported, the linking is assumed to be complete.
+ *
+ * @param shaderProgram ID of the shader program returned by
+ * abcg::triggerOpenGLShaderLink.
+ *
+ * @return `true` if abcg::checkOpenGLShaderLink would not wait for the
+ * linking; `false` otherwise.
+ */
+bool abcg::isOpenGLShaderLinkComplete(GLuint shaderProgram) {
+  return !isParallelCompileSupported() || isLinkComplete(shaderProgram);
 }
\ No newline at end of file
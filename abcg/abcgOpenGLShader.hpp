@@ -14,6 +14,7 @@
 #include "abcgOpenGLExternal.hpp"
 #include "abcgShader.hpp"
 
+#include <string_view>
 #include <vector>
 
 namespace abcg {
@@ -34,6 +35,9 @@ namespace abcg {
 [[nodiscard]] GLuint
 createOpenGLProgram(std::vector<ShaderSource> const &pathsOrSources,
                     bool throwOnError = true);
+[[nodiscard]] std::vector<GLuint> createOpenGLPrograms(
+    std::vector<std::vector<ShaderSource>> const &pathsOrSources,
+    bool throwOnError = true);
 [[nodiscard]] std::vector<abcg::OpenGLShader>
 triggerOpenGLShaderCompile(std::vector<ShaderSource> const &pathsOrSources);
 bool checkOpenGLShaderCompile(std::vector<OpenGLShader> const &shaders,
@@ -41,6 +45,10 @@ bool checkOpenGLShaderCompile(std::vector<OpenGLShader> const &shaders,
 GLuint triggerOpenGLShaderLink(std::vector<OpenGLShader> const &shaders,
                                bool throwOnError = true);
 bool checkOpenGLShaderLink(GLuint shaderProgram, bool throwOnError = true);
+[[nodiscard]] bool
+isOpenGLShaderCompileComplete(std::vector<OpenGLShader> const &shaders);
+[[nodiscard]] bool isOpenGLShaderLinkComplete(GLuint shaderProgram);
+void setOpenGLProgramCacheDirectory(std::string_view directory);
 } // namespace abcg
 
 #endif
@@ -0,0 +1,271 @@
+/**
+ * @file abcgOpenGLStateCache.cpp
+ * @brief Definition of abcg::OpenGLStateCache members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLStateCache.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Returns the state cache of the OpenGL context.
+ *
+ * @returns Reference to the singleton object.
+ */
+abcg::OpenGLStateCache &abcg::OpenGLStateCache::getInstance() {
+  static OpenGLStateCache cache;
+  return cache;
+}
+
+/**
+ * @brief Enables or disables the cache.
+ *
+ * The cached state is invalidated in both cases.
+ *
+ * @param enabled Whether redundant state changes are skipped.
+ */
+void abcg::OpenGLStateCache::setEnabled(bool const enabled) noexcept {
+  m_enabled = enabled;
+  invalidate();
+}
+
+/**
+ * @brief Forgets all cached state.
+ *
+ * The next state change of each kind is not skipped.
+ */
+void abcg::OpenGLStateCache::invalidate() noexcept {
+  m_program = unknown;
+  m_vertexArray = unknown;
+  m_buffers.fill(unknown);
+  m_activeTextureUnit = maxTextureUnits;
+  for (auto &unit : m_textures) {
+    unit.fill(unknown);
+  }
+  m_capabilities.fill(CapabilityState::Unknown);
+  m_texParameters.clear();
+}
+
+/**
+ * @brief Updates the cached value of an integer texture parameter of the
+ * texture bound to the given target.
+ *
+ * @param target Texture target.
+ * @param pname Texture parameter name.
+ * @param param Parameter value.
+ *
+ * @returns Whether `glTexParameteri` must be called.
+ */
+bool abcg::OpenGLStateCache::texParameteri(GLenum const target,
+                                           GLenum const pname,
+                                           GLint const param) {
+  if (!m_enabled)
+    return true;
+  auto const index{texParameterIndex(pname)};
+  auto const *bound{boundTexture(target)};
+  if (index >= numTexParameters || bound == nullptr || *bound == unknown)
+    return true;
+
+  auto [iter, inserted]{m_texParameters.try_emplace(*bound)};
+  if (inserted) {
+    iter->second.fill(unknownParameter);
+  }
+  if (iter->second.at(index) == param)
+    return skip();
+  iter->second.at(index) = param;
+  return true;
+}
+
+/**
+ * @brief Updates the cached buffer binding of a target without skipping the
+ * call.
+ *
+ * Used for `glBindBufferBase` and `glBindBufferRange`, which also bind the
+ * buffer to the generic binding point of the target.
+ *
+ * @param target Buffer target.
+ * @param buffer Buffer name.
+ */
+void abcg::OpenGLStateCache::setBufferBinding(GLenum const target,
+                                              GLuint const buffer) noexcept {
+  if (auto const index{bufferTargetIndex(target)};
+      m_enabled && index < numBufferTargets) {
+    m_buffers.at(index) = buffer;
+  }
+}
+
+/**
+ * @brief Forgets the cached value of a texture parameter of the texture bound
+ * to the given target.
+ *
+ * Used for the functions that set texture parameters without integer values.
+ *
+ * @param target Texture target.
+ * @param pname Texture parameter name.
+ */
+void abcg::OpenGLStateCache::forgetTexParameter(GLenum const target,
+                                                GLenum const pname) noexcept {
+  if (!m_enabled)
+    return;
+  auto const index{texParameterIndex(pname)};
+  auto const *bound{boundTexture(target)};
+  if (index >= numTexParameters || bound == nullptr)
+    return;
+  if (*bound == unknown) {
+    // The texture is not known, so forget the parameter of all textures
+    for (auto &[texture, parameters] : m_texParameters) {
+      parameters.at(index) = unknownParameter;
+    }
+  } else if (auto iter{m_texParameters.find(*bound)};
+             iter != m_texParameters.end()) {
+    iter->second.at(index) = unknownParameter;
+  }
+}
+
+/**
+ * @brief Forgets the program if it is the cached current program.
+ *
+ * @param program Program name.
+ */
+void abcg::OpenGLStateCache::forgetProgram(GLuint const program) noexcept {
+  if (m_program == program) {
+    m_program = unknown;
+  }
+}
+
+/**
+ * @brief Forgets the bindings of deleted buffers.
+ *
+ * @param buffers Buffer names.
+ */
+void abcg::OpenGLStateCache::forgetBuffers(
+    std::span<GLuint const> const buffers) noexcept {
+  for (auto const buffer : buffers) {
+    std::ranges::replace(m_buffers, buffer, unknown);
+  }
+}
+
+/**
+ * @brief Forgets the bindings and parameters of deleted textures.
+ *
+ * @param textures Texture names.
+ */
+void abcg::OpenGLStateCache::forgetTextures(
+    std::span<GLuint const> const textures) noexcept {
+  for (auto const texture : textures) {
+    for (auto &unit : m_textures) {
+      std::ranges::replace(unit, texture, unknown);
+    }
+    m_texParameters.erase(texture);
+  }
+}
+
+/**
+ * @brief Forgets the binding of deleted vertex arrays.
+ *
+ * @param arrays Vertex array names.
+ */
+void abcg::OpenGLStateCache::forgetVertexArrays(
+    std::span<GLuint const> const arrays) noexcept {
+  if (std::ranges::find(arrays, m_vertexArray) != arrays.end()) {
+    m_vertexArray = unknown;
+  }
+}
+
+std::size_t
+abcg::OpenGLStateCache::bufferTargetIndex(GLenum const target) noexcept {
+  switch (target) {
+  case GL_ARRAY_BUFFER:
+    return 0;
+  case GL_COPY_READ_BUFFER:
+    return 1;
+  case GL_COPY_WRITE_BUFFER:
+    return 2;
+  case GL_PIXEL_PACK_BUFFER:
+    return 3;
+  case GL_PIXEL_UNPACK_BUFFER:
+    return 4;
+  case GL_TRANSFORM_FEEDBACK_BUFFER:
+    return 5;
+  case GL_UNIFORM_BUFFER:
+    return 6;
+  default:
+    return numBufferTargets;
+  }
+}
+
+std::size_t
+abcg::OpenGLStateCache::textureTargetIndex(GLenum const target) noexcept {
+  switch (target) {
+  case GL_TEXTURE_2D:
+    return 0;
+  case GL_TEXTURE_CUBE_MAP:
+    return 1;
+  case GL_TEXTURE_3D:
+    return 2;
+  case GL_TEXTURE_2D_ARRAY:
+    return 3;
+  default:
+    return numTextureTargets;
+  }
+}
+
+std::size_t abcg::OpenGLStateCache::capabilityIndex(GLenum const cap) noexcept {
+  switch (cap) {
+  case GL_BLEND:
+    return 0;
+  case GL_CULL_FACE:
+    return 1;
+  case GL_DEPTH_TEST:
+    return 2;
+  case GL_DITHER:
+    return 3;
+  case GL_POLYGON_OFFSET_FILL:
+    return 4;
+  case GL_PRIMITIVE_RESTART_FIXED_INDEX:
+    return 5;
+  case GL_RASTERIZER_DISCARD:
+    return 6;
+  case GL_SAMPLE_ALPHA_TO_COVERAGE:
+    return 7;
+  case GL_SAMPLE_COVERAGE:
+    return 8;
+  case GL_SCISSOR_TEST:
+    return 9;
+  case GL_STENCIL_TEST:
+    return 10;
+#if !defined(__EMSCRIPTEN__)
+  case GL_FRAMEBUFFER_SRGB:
+    return 11;
+  case GL_MULTISAMPLE:
+    return 12;
+  case GL_PROGRAM_POINT_SIZE:
+    return 13;
+#endif
+  default:
+    return numCapabilities;
+  }
+}
+
+std::size_t
+abcg::OpenGLStateCache::texParameterIndex(GLenum const pname) noexcept {
+  switch (pname) {
+  case GL_TEXTURE_MIN_FILTER:
+    return 0;
+  case GL_TEXTURE_MAG_FILTER:
+    return 1;
+  case GL_TEXTURE_WRAP_S:
+    return 2;
+  case GL_TEXTURE_WRAP_T:
+    return 3;
+  case GL_TEXTURE_WRAP_R:
+    return 4;
+  default:
+    return numTexParameters;
+  }
+}
@@ -0,0 +1,201 @@
+/**
+ * @file abcgOpenGLStateCache.hpp
+ * @brief Header file of abcg::OpenGLStateCache.
+ *
+ * Declaration of abcg::OpenGLStateCache class.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_STATE_CACHE_HPP_
+#define ABCG_OPENGL_STATE_CACHE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <unordered_map>
+
+#include "abcgOpenGLExternal.hpp"
+
+namespace abcg {
+class OpenGLStateCache;
+} // namespace abcg
+
+/**
+ * @brief Shadow copy of OpenGL state used to skip redundant state changes.
+ *
+ * When enabled, the wrappers of `glUseProgram`, `glBindVertexArray`,
+ * `glBindBuffer`, `glActiveTexture`, `glBindTexture`, `glEnable`, `glDisable`
+ * and `glTexParameteri` in the abcg namespace skip the calls that would not
+ * change the current state. The state of objects deleted through the
+ * wrappers is forgotten.
+ *
+ * The cache is invalidated by abcg::OpenGLWindow before calling
+ * abcg::OpenGLWindow::onPaint. State changed with functions called without
+ * the wrappers (e.g. `::glBindTexture`) is not tracked. Call
+ * abcg::OpenGLStateCache::invalidate after such calls.
+ *
+ * Element array buffer bindings are part of the vertex array state and are
+ * never cached.
+ *
+ * @sa abcg::OpenGLSettings::stateCache.
+ */
+class abcg::OpenGLStateCache {
+public:
+  /** @brief Number of texture units whose bindings are cached. */
+  static constexpr std::size_t maxTextureUnits{32};
+
+  static OpenGLStateCache &getInstance();
+
+  void setEnabled(bool enabled) noexcept;
+  [[nodiscard]] bool isEnabled() const noexcept { return m_enabled; }
+  void invalidate() noexcept;
+
+  [[nodiscard]] std::uint64_t getNumSkippedCalls() const noexcept {
+    return m_numSkippedCalls;
+  }
+
+  // The following functions update the cached state and return whether the
+  // corresponding OpenGL function must be called
+  [[nodiscard]] bool useProgram(GLuint program) noexcept;
+  [[nodiscard]] bool bindVertexArray(GLuint array) noexcept;
+  [[nodiscard]] bool bindBuffer(GLenum target, GLuint buffer) noexcept;
+  [[nodiscard]] bool activeTexture(GLenum texture) noexcept;
+  [[nodiscard]] bool bindTexture(GLenum target, GLuint texture) noexcept;
+  [[nodiscard]] bool setCapability(GLenum cap, bool enabled) noexcept;
+  [[nodiscard]] bool texParameteri(GLenum target, GLenum pname, GLint param);
+
+  void setBufferBinding(GLenum target, GLuint buffer) noexcept;
+  void forgetTexParameter(GLenum target, GLenum pname) noexcept;
+  void forgetProgram(GLuint program) noexcept;
+  void forgetBuffers(std::span<GLuint const> buffers) noexcept;
+  void forgetTextures(std::span<GLuint const> textures) noexcept;
+  void forgetVertexArrays(std::span<GLuint const> arrays) noexcept;
+
+private:
+  // Name used for state that is not known
+  static constexpr GLuint unknown{std::numeric_limits<GLuint>::max()};
+  static constexpr GLint unknownParameter{std::numeric_limits<GLint>::min()};
+
+  static constexpr std::size_t numBufferTargets{7};
+  static constexpr std::size_t numTextureTargets{4};
+  static constexpr std::size_t numCapabilities{14};
+  static constexpr std::size_t numTexParameters{5};
+
+  enum class CapabilityState : std::uint8_t { Unknown, Disabled, Enabled };
+
+  [[nodiscard]] static std::size_t bufferTargetIndex(GLenum target) noexcept;
+  [[nodiscard]] static std::size_t textureTargetIndex(GLenum target) noexcept;
+  [[nodiscard]] static std::size_t capabilityIndex(GLenum cap) noexcept;
+  [[nodiscard]] static std::size_t texParameterIndex(GLenum pname) noexcept;
+
+  [[nodiscard]] GLuint *boundTexture(GLenum target) noexcept;
+  [[nodiscard]] bool skip() noexcept;
+
+  using TexParameters = std::array<GLint, numTexParameters>;
+
+  bool m_enabled{};
+  GLuint m_program{unknown};
+  GLuint m_vertexArray{unknown};
+  std::array<GLuint, numBufferTargets> m_buffers{};
+  // Index of the active texture unit, or maxTextureUnits if unknown or not
+  // cached
+  std::size_t m_activeTextureUnit{maxTextureUnits};
+  std::array<std::array<GLuint, numTextureTargets>, maxTextureUnits>
+      m_textures{};
+  std::array<CapabilityState, numCapabilities> m_capabilities{};
+  std::unordered_map<GLuint, TexParameters> m_texParameters;
+  std::uint64_t m_numSkippedCalls{};
+};
+
+inline bool abcg::OpenGLStateCache::skip() noexcept {
+  ++m_numSkippedCalls;
+  return false;
+}
+
+inline bool abcg::OpenGLStateCache::useProgram(GLuint const program) noexcept {
+  if (!m_enabled)
+    return true;
+  if (m_program == program)
+    return skip();
+  m_program = program;
+  return true;
+}
+
+inline bool
+abcg::OpenGLStateCache::bindVertexArray(GLuint const array) noexcept {
+  if (!m_enabled)
+    return true;
+  if (m_vertexArray == array)
+    return skip();
+  m_vertexArray = array;
+  return true;
+}
+
+inline bool abcg::OpenGLStateCache::bindBuffer(GLenum const target,
+                                               GLuint const buffer) noexcept {
+  if (!m_enabled)
+    return true;
+  auto const index{bufferTargetIndex(target)};
+  if (index >= numBufferTargets)
+    return true;
+  if (m_buffers[index] == buffer)
+    return skip();
+  m_buffers[index] = buffer;
+  return true;
+}
+
+inline bool
+abcg::OpenGLStateCache::activeTexture(GLenum const texture) noexcept {
+  if (!m_enabled)
+    return true;
+  auto const unit{static_cast<std::size_t>(texture - GL_TEXTURE0)};
+  if (unit < maxTextureUnits && unit == m_activeTextureUnit)
+    return skip();
+  m_activeTextureUnit = std::min(unit, maxTextureUnits);
+  return true;
+}
+
+inline GLuint *
+abcg::OpenGLStateCache::boundTexture(GLenum const target) noexcept {
+  auto const index{textureTargetIndex(target)};
+  if (m_activeTextureUnit >= maxTextureUnits || index >= numTextureTargets)
+    return nullptr;
+  return &m_textures[m_activeTextureUnit][index];
+}
+
+inline bool abcg::OpenGLStateCache::bindTexture(GLenum const target,
+                                                GLuint const texture) noexcept {
+  if (!m_enabled)
+    return true;
+  auto *bound{boundTexture(target)};
+  if (bound == nullptr)
+    return true;
+  if (*bound == texture)
+    return skip();
+  *bound = texture;
+  return true;
+}
+
+inline bool abcg::OpenGLStateCache::setCapability(GLenum const cap,
+                                                  bool const enabled) noexcept {
+  if (!m_enabled)
+    return true;
+  auto const index{capabilityIndex(cap)};
+  if (index >= numCapabilities)
+    return true;
+  auto const state{enabled ? CapabilityState::Enabled
+                           : CapabilityState::Disabled};
+  if (m_capabilities[index] == state)
+    return skip();
+  m_capabilities[index] = state;
+  return true;
+}
+
+#endif
@@ -12,11 +12,23 @@
 
 #include <SDL_events.h>
 #include <SDL_image.h>
+#include <cstdlib>
 #include <imgui_impl_opengl3.h>
 #include <imgui_impl_sdl2.h>
 
+#if defined(ABCG_HAS_EGL)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include "abcgApplication.hpp"
 #include "abcgEmbeddedFonts.hpp"
 #include "abcgException.hpp"
+#include "abcgOpenGLCallStats.hpp"
+#include "abcgOpenGLGPUProfiler.hpp"
+#include "abcgOpenGLShader.hpp"
+#include "abcgOpenGLStateCache.hpp"
+#include "abcgProfiler.hpp"
 #include "abcgWindow.hpp"
 
 /**
@@ -125,37 +137,55 @@ void abcg::OpenGLWindow::onPaint() {
  *
  * This is not called when the window is minimized.
  *
- * Override it for custom behavior. By default, it shows a FPS counter if
- * abcg::WindowSettings::showFPS is set to `true`, and a toggle fullscreen
- * button if abcg::WindowSettings::showFullscreenButton is set to `true`.
+ * Override it for custom behavior. By default, it shows the frame time
+ * statistics of abcg::FrameStats, the OpenGL call counts of
+ * abcg::OpenGLCallStats and a flame graph of the zones recorded by
+ * abcg::Profiler if abcg::WindowSettings::showFPS is set to `true`, and a
+ * toggle fullscreen button if abcg::WindowSettings::showFullscreenButton is
+ * set to `true`.
  */
 void abcg::OpenGLWindow::onPaintUI() {
-  // FPS counter
+  // Frame time statistics and flame graph of the profiled zones
   if (abcg::Window::getWindowSettings().showFPS) {
-    auto fps{ImGui::GetIO().Framerate};
+    auto const &frameStats{abcg::Window::getFrameStats()};
 
-    static auto offset{0UL};
+    // Refresh the displayed statistics and frame a few times per second so
+    // that they can be read
     static auto refreshTime{ImGui::GetTime()};
-    static std::array<float, 150> frames{};
-
-    while (refreshTime < ImGui::GetTime()) {
-      auto const refreshFrequency{60.0};
-      frames.at(offset) = fps;
-      offset = (offset + 1) % frames.size();
-      refreshTime += (1.0 / refreshFrequency);
+    static FrameStatsSummary stats;
+    static ProfilerFrame frame;
+    static auto gpuTime{0.0};
+    static OpenGLCallCounts callCounts;
+    if (refreshTime < ImGui::GetTime()) {
+      auto const refreshFrequency{4.0};
+      stats = frameStats.getSummary();
+      callCounts = OpenGLCallStats::getInstance().getLastFrame();
+      // GPU timings are available only after a few frames
+      auto const &gpuProfiler{OpenGLGPUProfiler::getInstance()};
+      frame = Profiler::getInstance().getFrame(
+          gpuProfiler.isSupported() ? OpenGLGPUProfiler::framesInFlight : 0);
+      gpuTime = 0.0;
+      for (auto const &zone : frame.gpuZones) {
+        if (zone.depth == 0) {
+          gpuTime += zone.end - zone.start;
+        }
+      }
+      refreshTime = ImGui::GetTime() + 1.0 / refreshFrequency;
     }
 
     ImGui::SetNextWindowPos(ImVec2(5, 5));
     ImGui::Begin("FPS", nullptr,
                  ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs |
                      ImGuiWindowFlags_NoBringToFrontOnFocus |
-                     ImGuiWindowFlags_NoFocusOnAppearing);
-    auto const label{fmt::format("avg {:.1f} FPS", fps)};
-    ImGui::PlotLines("", frames.data(), gsl::narrow<int>(frames.size()),
-                     gsl::narrow<int>(offset), label.c_str(), 0.0f,
-                     // *std::ranges::max_element(frames) * 2,
-                     *std::max_element(frames.begin(), frames.end()) * 2,
-                     ImVec2(gsl::narrow<float>(frames.size()), 50));
+                     ImGuiWindowFlags_NoFocusOnAppearing |
+                     ImGuiWindowFlags_AlwaysAutoResize);
+    frameStats.show(stats, 300.0f);
+    if (!frame.gpuZones.empty()) {
+      auto const gpuLabel{fmt::format("GPU {:.2f} ms", gpuTime * 1000.0)};
+      ImGui::TextUnformatted(gpuLabel.c_str());
+    }
+    OpenGLCallStats::show(callCounts);
+    Profiler::showFlameGraph(frame, 300.0f);
     ImGui::End();
   }
 
@@ -206,13 +236,35 @@ void abcg::OpenGLWindow::onResize([[maybe_unused]] glm::ivec2 const &size) {}
 /**
  * @brief Custom handler called for each frame before painting.
  *
- * This virtual function is called just before abcg::VulkanWindow::onPaint, even
+ * This virtual function is called just before abcg::OpenGLWindow::onPaint, even
  * if the window is minimized.
  *
+ * If abcg::WindowSettings::pipelinedUpdate is enabled, this is called on a
+ * worker thread while the previous frame is painted. In this case, do not
+ * call graphics API or Dear ImGui functions here, and pass the results to
+ * abcg::OpenGLWindow::onPaint through an abcg::FrameState.
+ *
  * Override it for custom behavior. By default, it does nothing.
  */
 void abcg::OpenGLWindow::onUpdate() {}
 
+/**
+ * @brief Custom handler called at a fixed rate.
+ *
+ * This virtual function is called zero or more times per frame, before
+ * abcg::OpenGLWindow::onUpdate, with a constant time step given by
+ * abcg::WindowSettings::fixedDeltaTime. Use it for simulation and game logic
+ * that must not depend on the frame rate. Use
+ * abcg::Window::getInterpolationAlpha in abcg::OpenGLWindow::onPaint to
+ * interpolate between the last two simulation states.
+ *
+ * Override it for custom behavior. By default, it does nothing.
+ *
+ * @param deltaTime Time step, in seconds.
+ */
+void abcg::OpenGLWindow::onFixedUpdate(
+    [[maybe_unused]] double deltaTime) {}
+
 /**
  * @brief Custom handler for cleaning up OpenGL resources.
  *
@@ -298,76 +350,60 @@ void abcg::OpenGLWindow::create() {
 
   switch (profile) {
   case OpenGLProfile::Core:
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS,
-                        SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK,
-                        SDL_GL_CONTEXT_PROFILE_CORE);
     m_GLSLVersion += " core";
     break;
   case OpenGLProfile::Compatibility:
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, 0);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK,
-                        SDL_GL_CONTEXT_PROFILE_COMPATIBILITY);
     m_GLSLVersion += " compatibility";
     break;
   case OpenGLProfile::ES:
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, 0);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
     m_GLSLVersion += " es";
     break;
   }
 
-  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, majorVersion);
-  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, minorVersion);
-  SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER,
-                      m_openGLSettings.doubleBuffering ? 1 : 0);
-  SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, m_openGLSettings.depthBufferSize);
-  SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, m_openGLSettings.stencilBufferSize);
-
-  if (m_openGLSettings.samples > 0) {
-    // Enable multisampling
-    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
-    // Can be 2, 4, 8 or 16
-    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, m_openGLSettings.samples);
+  if (isHeadless()) {
+    createEGLContext();
   } else {
-    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 0);
+    createSDLContext();
   }
 
-  // Create window with graphics context
-  while (true) {
-    if (!createSDLWindow(SDL_WINDOW_OPENGL) && m_openGLSettings.samples > 0) {
-      // Try again, but this time with multisampling disabled
-      m_openGLSettings.samples = 0;
-      SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 0);
-      SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 0);
-      fmt::print("Warning: multisampling requested but not supported!\n");
-    } else {
-      break;
-    }
+#if !defined(__EMSCRIPTEN__)
+  if (auto const err{glewInit()}; GLEW_OK != err) {
+#if defined(GLEW_ERROR_NO_GLX_DISPLAY)
+    // GLEW built for GLX reports this after successfully loading the entry
+    // points of an EGL context
+    if (!isHeadless() || err != GLEW_ERROR_NO_GLX_DISPLAY)
+#endif
+      throw abcg::Exception{
+          fmt::format("Failed to initialize OpenGL loader: {}",
+                      reinterpret_cast<char const *>(glewGetErrorString(err)))};
   }
+  fmt::print("Using GLEW.....: {}\n",
+             reinterpret_cast<char const *>(glewGetString(GLEW_VERSION)));
+#endif
 
-  if (abcg::Window::getSDLWindow() == nullptr) {
-    throw abcg::SDLError("SDL_CreateWindow failed");
+#if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+  if (isDebugContextRequested()) {
+    if (installGLDebugCallback()) {
+      fmt::print("GL error check.: KHR_debug callback\n");
+    } else {
+      fmt::print("GL error check.: glGetError (KHR_debug not supported)\n");
+    }
   }
 
-  // Create OpenGL context
-  m_GLContext = SDL_GL_CreateContext(abcg::Window::getSDLWindow());
-  if (m_GLContext == nullptr) {
-    throw abcg::SDLError("SDL_GL_CreateContext failed");
+  setGLCheckPolicy(m_openGLSettings.errorCheckPolicy,
+                   gsl::narrow<std::uint64_t>(
+                       std::max(m_openGLSettings.errorCheckInterval, 1)));
+  auto checkRange{m_openGLSettings.errorCheckRange};
+  if (auto const *envCheckRange{std::getenv("ABCG_GL_CHECK_RANGE")};
+      checkRange.empty() && envCheckRange != nullptr) {
+    checkRange = envCheckRange;
   }
-
-#if !defined(__EMSCRIPTEN__)
-  SDL_GL_SetSwapInterval(m_openGLSettings.vSync ? 1 : 0);
-#endif
-
-#if !defined(__EMSCRIPTEN__)
-  if (auto const err{glewInit()}; GLEW_OK != err) {
-    throw abcg::Exception{
-        fmt::format("Failed to initialize OpenGL loader: {}",
-                    reinterpret_cast<char const *>(glewGetErrorString(err)))};
+  if (checkRange.empty()) {
+    clearGLCheckRange();
+  } else {
+    setGLCheckRange(checkRange);
+    fmt::print("GL check range.: calls {} of each frame\n", checkRange);
   }
-  fmt::print("Using GLEW.....: {}\n",
-             reinterpret_cast<char const *>(glewGetString(GLEW_VERSION)));
 #endif
 
   fmt::print("OpenGL vendor..: {}\n",
@@ -404,7 +440,9 @@ void abcg::OpenGLWindow::create() {
   guiIO.IniFilename = nullptr;
 
   // Setup platform/renderer bindings
-  ImGui_ImplSDL2_InitForOpenGL(abcg::Window::getSDLWindow(), m_GLContext);
+  if (!isHeadless()) {
+    ImGui_ImplSDL2_InitForOpenGL(abcg::Window::getSDLWindow(), m_GLContext);
+  }
   ImGui_ImplOpenGL3_Init(m_GLSLVersion.c_str());
 
   // Load fonts
@@ -419,18 +457,41 @@ void abcg::OpenGLWindow::create() {
     throw abcg::RuntimeError("Failed to load font file");
   }
 
+  OpenGLGPUProfiler::getInstance().create();
+
+  OpenGLStateCache::getInstance().setEnabled(m_openGLSettings.stateCache);
+  if (m_openGLSettings.stateCache) {
+    fmt::print("GL state cache.: enabled\n");
+  }
+
+  if (m_openGLSettings.programBinaryCache) {
+    auto const cacheDirectory{Application::getBasePath() + "/cache"};
+    setOpenGLProgramCacheDirectory(cacheDirectory);
+    fmt::print("Program cache..: {}\n", cacheDirectory);
+  } else {
+    setOpenGLProgramCacheDirectory({});
+  }
+
   onCreate();
 
   onResize(getWindowSize());
 }
 
-void abcg::OpenGLWindow::paint() {
-  onUpdate();
+void abcg::OpenGLWindow::fixedUpdate(double deltaTime) {
+  onFixedUpdate(deltaTime);
+}
+
+void abcg::OpenGLWindow::update() { onUpdate(); }
 
+void abcg::OpenGLWindow::paint() {
   if (m_hidden || m_minimized)
     return;
 
-  SDL_GL_MakeCurrent(abcg::Window::getSDLWindow(), m_GLContext);
+  makeContextCurrent();
+
+#if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+  beginGLFrameChecks();
+#endif
 
 #if defined(__EMSCRIPTEN__)
   // Force window size in windowed mode
@@ -444,17 +505,61 @@ void abcg::OpenGLWindow::paint() {
 #endif
 
   ImGui_ImplOpenGL3_NewFrame();
-  ImGui_ImplSDL2_NewFrame();
+  if (isHeadless()) {
+    // There is no platform backend to feed Dear ImGui in headless mode
+    auto &guiIO{ImGui::GetIO()};
+    auto const size{getWindowSize()};
+    guiIO.DisplaySize =
+        ImVec2(gsl::narrow<float>(size.x), gsl::narrow<float>(size.y));
+    guiIO.DeltaTime =
+        std::max(gsl::narrow_cast<float>(getDeltaTime()), 1.0f / 10000.0f);
+  } else {
+    ImGui_ImplSDL2_NewFrame();
+  }
   ImGui::NewFrame();
 
-  onPaintUI();
+  {
+    ABCG_PROFILE_ZONE("onPaintUI");
+    onPaintUI();
+  }
+
+  {
+    ABCG_PROFILE_ZONE("ImGui::Render");
+    ImGui::Render();
+  }
+
+  auto &gpuProfiler{OpenGLGPUProfiler::getInstance()};
+  gpuProfiler.beginFrame();
+
+  {
+    ABCG_PROFILE_ZONE("onPaint");
+    ABCG_GPU_ZONE("onPaint");
+    // State may have been changed by functions called without the wrappers
+    OpenGLStateCache::getInstance().invalidate();
+    onPaint();
+  }
+
+  {
+    ABCG_PROFILE_ZONE("ImGui draw");
+    ABCG_GPU_ZONE("ImGui draw");
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+  }
+  // Dear ImGui changes the state without the wrappers
+  OpenGLStateCache::getInstance().invalidate();
+  OpenGLCallStats::getInstance().endFrame();
 
-  ImGui::Render();
+  gpuProfiler.endFrame();
 
-  onPaint();
+#if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+  // Detect errors of calls skipped by the checking policy
+  endGLFrameChecks();
+#endif
 
-  ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-  if (m_openGLSettings.doubleBuffering) {
+  ABCG_PROFILE_ZONE("Swap");
+  if (isHeadless()) {
+    // Wait for the GPU so that the frame time accounts for the rendering cost
+    glFinish();
+  } else if (m_openGLSettings.doubleBuffering) {
     SDL_GL_SwapWindow(abcg::Window::getSDLWindow());
   } else {
     glFinish();
@@ -464,21 +569,251 @@ void abcg::OpenGLWindow::paint() {
 void abcg::OpenGLWindow::destroy() {
   onDestroy();
 
+  OpenGLGPUProfiler::getInstance().destroy();
+  OpenGLStateCache::getInstance().setEnabled(false);
+
   if (ImGui::GetCurrentContext() != nullptr) {
     ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplSDL2_Shutdown();
+    if (!isHeadless()) {
+      ImGui_ImplSDL2_Shutdown();
+    }
     ImGui::DestroyContext();
   }
+#if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+  uninstallGLDebugCallback();
+#endif
   if (m_GLContext != nullptr) {
     SDL_GL_DeleteContext(m_GLContext);
     m_GLContext = nullptr;
   }
+#if defined(ABCG_HAS_EGL)
+  if (m_EGLDisplay != nullptr) {
+    eglMakeCurrent(m_EGLDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                   EGL_NO_CONTEXT);
+    if (m_EGLContext != nullptr) {
+      eglDestroyContext(m_EGLDisplay, m_EGLContext);
+    }
+    if (m_EGLSurface != nullptr) {
+      eglDestroySurface(m_EGLDisplay, m_EGLSurface);
+    }
+    eglTerminate(m_EGLDisplay);
+    m_EGLContext = nullptr;
+    m_EGLSurface = nullptr;
+    m_EGLDisplay = nullptr;
+  }
+#endif
 }
 
 [[nodiscard]] glm::ivec2 abcg::OpenGLWindow::getWindowSize() const {
+  if (isHeadless()) {
+    auto const &windowSettings{abcg::Window::getWindowSettings()};
+    return {windowSettings.width, windowSettings.height};
+  }
+
   glm::ivec2 size{};
   if (auto *window{abcg::Window::getSDLWindow()}; window != nullptr) {
     SDL_GL_GetDrawableSize(window, &size.x, &size.y);
   }
   return size;
 }
+
+// Whether the context must be created with the debug flag for the KHR_debug
+// error checking backend
+bool abcg::OpenGLWindow::isDebugContextRequested() const noexcept {
+#if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+  return m_openGLSettings.errorBackend == OpenGLErrorBackend::DebugCallback;
+#else
+  return false;
+#endif
+}
+
+void abcg::OpenGLWindow::createSDLContext() {
+  auto const majorVersion{m_openGLSettings.majorVersion};
+  auto const minorVersion{m_openGLSettings.minorVersion};
+
+  auto const debugFlag{isDebugContextRequested() ? SDL_GL_CONTEXT_DEBUG_FLAG
+                                                 : 0};
+
+  switch (m_openGLSettings.profile) {
+  case OpenGLProfile::Core:
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS,
+                        SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG | debugFlag);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK,
+                        SDL_GL_CONTEXT_PROFILE_CORE);
+    break;
+  case OpenGLProfile::Compatibility:
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, debugFlag);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK,
+                        SDL_GL_CONTEXT_PROFILE_COMPATIBILITY);
+    break;
+  case OpenGLProfile::ES:
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, debugFlag);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
+    break;
+  }
+
+  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, majorVersion);
+  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, minorVersion);
+  SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER,
+                      m_openGLSettings.doubleBuffering ? 1 : 0);
+  SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, m_openGLSettings.depthBufferSize);
+  SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, m_openGLSettings.stencilBufferSize);
+
+  if (m_openGLSettings.samples > 0) {
+    // Enable multisampling
+    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
+    // Can be 2, 4, 8 or 16
+    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, m_openGLSettings.samples);
+  } else {
+    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 0);
+  }
+
+  // Create window with graphics context
+  while (true) {
+    if (!createSDLWindow(SDL_WINDOW_OPENGL) && m_openGLSettings.samples > 0) {
+      // Try again, but this time with multisampling disabled
+      m_openGLSettings.samples = 0;
+      SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 0);
+      SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 0);
+      fmt::print("Warning: multisampling requested but not supported!\n");
+    } else {
+      break;
+    }
+  }
+
+  if (abcg::Window::getSDLWindow() == nullptr) {
+    throw abcg::SDLError("SDL_CreateWindow failed");
+  }
+
+  // Create OpenGL context
+  m_GLContext = SDL_GL_CreateContext(abcg::Window::getSDLWindow());
+  if (m_GLContext == nullptr) {
+    throw abcg::SDLError("SDL_GL_CreateContext failed");
+  }
+
+#if !defined(__EMSCRIPTEN__)
+  SDL_GL_SetSwapInterval(m_openGLSettings.vSync ? 1 : 0);
+#endif
+}
+
+// Creates an OpenGL context bound to an offscreen pbuffer surface of size
+// (WindowSettings::width, WindowSettings::height).
+void abcg::OpenGLWindow::createEGLContext() {
+#if defined(ABCG_HAS_EGL)
+  // Try the default display first. If it is not available (e.g., there is no
+  // X server), fall back to the displays of the EGL devices, if any.
+  auto *display{eglGetDisplay(EGL_DEFAULT_DISPLAY)};
+  EGLint major{};
+  EGLint minor{};
+  if (display == EGL_NO_DISPLAY ||
+      eglInitialize(display, &major, &minor) != EGL_TRUE) {
+    display = EGL_NO_DISPLAY;
+    auto const queryDevices{reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(
+        eglGetProcAddress("eglQueryDevicesEXT"))};
+    auto const getPlatformDisplay{
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"))};
+    if (queryDevices != nullptr && getPlatformDisplay != nullptr) {
+      std::array<EGLDeviceEXT, 8> devices{};
+      EGLint numDevices{};
+      queryDevices(gsl::narrow<EGLint>(devices.size()), devices.data(),
+                   &numDevices);
+      for (auto const index : iter::range(numDevices)) {
+        auto *device{devices.at(gsl::narrow<std::size_t>(index))};
+        display = getPlatformDisplay(EGL_PLATFORM_DEVICE_EXT, device, nullptr);
+        if (display != EGL_NO_DISPLAY &&
+            eglInitialize(display, &major, &minor) == EGL_TRUE) {
+          break;
+        }
+        display = EGL_NO_DISPLAY;
+      }
+    }
+  }
+  if (display == EGL_NO_DISPLAY) {
+    throw abcg::RuntimeError("Failed to initialize EGL display");
+  }
+  m_EGLDisplay = display;
+
+  auto const isES{m_openGLSettings.profile == OpenGLProfile::ES};
+  if (eglBindAPI(isES ? EGL_OPENGL_ES_API : EGL_OPENGL_API) != EGL_TRUE) {
+    throw abcg::RuntimeError("eglBindAPI failed");
+  }
+
+  std::array const configAttributes{
+      EGL_SURFACE_TYPE,
+      EGL_PBUFFER_BIT,
+      EGL_RENDERABLE_TYPE,
+      isES ? EGL_OPENGL_ES3_BIT : EGL_OPENGL_BIT,
+      EGL_RED_SIZE,
+      8,
+      EGL_GREEN_SIZE,
+      8,
+      EGL_BLUE_SIZE,
+      8,
+      EGL_ALPHA_SIZE,
+      8,
+      EGL_DEPTH_SIZE,
+      m_openGLSettings.depthBufferSize,
+      EGL_STENCIL_SIZE,
+      m_openGLSettings.stencilBufferSize,
+      EGL_SAMPLE_BUFFERS,
+      m_openGLSettings.samples > 0 ? 1 : 0,
+      EGL_SAMPLES,
+      m_openGLSettings.samples,
+      EGL_NONE};
+  EGLConfig config{};
+  EGLint numConfigs{};
+  if (eglChooseConfig(display, configAttributes.data(), &config, 1,
+                      &numConfigs) != EGL_TRUE ||
+      numConfigs == 0) {
+    throw abcg::RuntimeError("eglChooseConfig failed");
+  }
+
+  auto const &windowSettings{abcg::Window::getWindowSettings()};
+  std::array const surfaceAttributes{EGL_WIDTH, windowSettings.width,
+                                     EGL_HEIGHT, windowSettings.height,
+                                     EGL_NONE};
+  m_EGLSurface =
+      eglCreatePbufferSurface(display, config, surfaceAttributes.data());
+  if (m_EGLSurface == EGL_NO_SURFACE) {
+    throw abcg::RuntimeError("eglCreatePbufferSurface failed");
+  }
+
+  EGLint profileMask{EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT};
+  if (m_openGLSettings.profile == OpenGLProfile::Compatibility) {
+    profileMask = EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT;
+  }
+  std::array const contextAttributes{
+      EGL_CONTEXT_MAJOR_VERSION,
+      m_openGLSettings.majorVersion,
+      EGL_CONTEXT_MINOR_VERSION,
+      m_openGLSettings.minorVersion,
+      EGL_CONTEXT_OPENGL_DEBUG,
+      isDebugContextRequested() ? EGL_TRUE : EGL_FALSE,
+      isES ? EGL_NONE : EGL_CONTEXT_OPENGL_PROFILE_MASK,
+      profileMask,
+      EGL_NONE};
+  m_EGLContext = eglCreateContext(display, config, EGL_NO_CONTEXT,
+                                  contextAttributes.data());
+  if (m_EGLContext == EGL_NO_CONTEXT) {
+    throw abcg::RuntimeError("eglCreateContext failed");
+  }
+
+  makeContextCurrent();
+
+  fmt::print("Using EGL......: {}.{} (headless {}x{})\n", major, minor,
+             windowSettings.width, windowSettings.height);
+#else
+  throw abcg::RuntimeError("Headless mode requires EGL support");
+#endif
+}
+
+void abcg::OpenGLWindow::makeContextCurrent() const {
+#if defined(ABCG_HAS_EGL)
+  if (isHeadless()) {
+    eglMakeCurrent(m_EGLDisplay, m_EGLSurface, m_EGLSurface, m_EGLContext);
+    return;
+  }
+#endif
+  SDL_GL_MakeCurrent(abcg::Window::getSDLWindow(), m_GLContext);
+}
@@ -21,6 +21,7 @@
 
 namespace abcg {
 enum class OpenGLProfile;
+enum class OpenGLErrorBackend;
 class OpenGLWindow;
 struct OpenGLSettings;
 } // namespace abcg
@@ -48,6 +49,24 @@ enum class abcg::OpenGLProfile {
   ES
 };
 
+/**
+ * @brief Enumeration of the ways the OpenGL error checking wrappers detect
+ * errors in debug builds.
+ *
+ * @sa abcg::OpenGLSettings.
+ */
+enum class abcg::OpenGLErrorBackend {
+  /** @brief Check with `glGetError` before and after each call. */
+  GetError,
+  /** @brief Create a debug context and report errors through a synchronous
+   * KHR_debug callback.
+   *
+   * This avoids the two `glGetError` round trips per call. Falls back to
+   * abcg::OpenGLErrorBackend::GetError if KHR_debug is not supported.
+   */
+  DebugCallback
+};
+
 /**
  * @brief Configuration settings for creating an OpenGL context.
  *
@@ -77,6 +96,48 @@ struct abcg::OpenGLSettings {
   bool vSync{false};
   /** @brief Whether the output is double buffered. */
   bool doubleBuffering{true};
+  /** @brief How OpenGL errors are detected in debug builds.
+   *
+   * The default is abcg::OpenGLErrorBackend::DebugCallback if ABCg is built
+   * with the CMake option `ENABLE_GL_DEBUG_CALLBACK`, and
+   * abcg::OpenGLErrorBackend::GetError otherwise. This is ignored in release
+   * builds, on macOS and on WebGL.
+   */
+#if defined(ABCG_GL_DEBUG_CALLBACK)
+  OpenGLErrorBackend errorBackend{OpenGLErrorBackend::DebugCallback};
+#else
+  OpenGLErrorBackend errorBackend{OpenGLErrorBackend::GetError};
+#endif
+  /** @brief Which calls are checked with `glGetError` in debug builds.
+   *
+   * Use a sampled or deferred policy to reduce the cost of error checking.
+   * This is ignored by the abcg::OpenGLErrorBackend::DebugCallback backend.
+   */
+  OpenGLCheckPolicy errorCheckPolicy{OpenGLCheckPolicy::EveryCall};
+  /** @brief Number of calls between checks for
+   * abcg::OpenGLCheckPolicy::EveryNthCall. */
+  int errorCheckInterval{64};
+  /** @brief Range of call indices within each frame that are always checked,
+   * in the format `first:last`.
+   *
+   * If empty, the environment variable `ABCG_GL_CHECK_RANGE` is used. Errors
+   * detected after unchecked calls report the range to use for finding the
+   * faulty call.
+   *
+   * @sa abcg::setGLCheckRange.
+   */
+  std::string errorCheckRange{};
+  /** @brief Whether the OpenGL wrappers skip redundant state changes.
+   *
+   * @sa abcg::OpenGLStateCache.
+   */
+  bool stateCache{false};
+  /** @brief Whether abcg::createOpenGLProgram caches program binaries on
+   * disk, in the `cache` subdirectory of abcg::Application::getBasePath.
+   *
+   * @sa abcg::setOpenGLProgramCacheDirectory.
+   */
+  bool programBinaryCache{false};
 };
 
 /**
@@ -92,6 +153,8 @@ struct abcg::OpenGLSettings {
  * @sa abcg::OpenGLWindow::onPaintUI for UI rendering.
  * @sa abcg::OpenGLWindow::onResize for handling of window resize events.
  * @sa abcg::OpenGLWindow::onUpdate for commands to be called every frame.
+ * @sa abcg::OpenGLWindow::onFixedUpdate for commands to be called at a fixed
+ * rate.
  * @sa abcg::OpenGLWindow::onDestroy for cleaning up OpenGL resources.
 
  * @remark Objects of this type cannot be copied or copy-constructed.
@@ -109,18 +172,30 @@ protected:
   virtual void onPaintUI();
   virtual void onResize(glm::ivec2 const &size);
   virtual void onUpdate();
+  virtual void onFixedUpdate(double deltaTime);
   virtual void onDestroy();
 
 private:
   void handleEvent(SDL_Event const &event) final;
   void create() final;
   void paint() final;
+  void fixedUpdate(double deltaTime) final;
+  void update() final;
   void destroy() final;
   [[nodiscard]] glm::ivec2 getWindowSize() const final;
 
+  void createSDLContext();
+  void createEGLContext();
+  void makeContextCurrent() const;
+  [[nodiscard]] bool isDebugContextRequested() const noexcept;
+
   OpenGLSettings m_openGLSettings;
   std::string m_GLSLVersion;
   SDL_GLContext m_GLContext{};
+  // EGL handles used in headless mode
+  void *m_EGLDisplay{};
+  void *m_EGLSurface{};
+  void *m_EGLContext{};
   bool m_hidden{};
   bool m_minimized{};
 };
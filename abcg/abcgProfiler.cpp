@@ -0,0 +1,287 @@
+/**
+ * @file abcgProfiler.cpp
+ * @brief Definition of abcg::Profiler and abcg::ProfilerZone members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgProfiler.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <string_view>
+#include <utility>
+
+namespace {
+// Index assigned by the profiler to the current thread
+thread_local std::uint32_t currentThreadIndex{UINT32_MAX};
+// Number of zones currently open in the current thread
+thread_local std::uint32_t currentThreadDepth{};
+} // namespace
+
+/**
+ * @brief Returns the profiler instance.
+ */
+abcg::Profiler &abcg::Profiler::getInstance() {
+  static Profiler profiler;
+  return profiler;
+}
+
+/**
+ * @brief Enables or disables the recording of zones.
+ *
+ * The profiler is enabled by default.
+ *
+ * @param enabled Whether to record zones.
+ */
+void abcg::Profiler::setEnabled(bool enabled) noexcept { m_enabled = enabled; }
+
+/**
+ * @brief Returns whether zones are being recorded.
+ */
+bool abcg::Profiler::isEnabled() const noexcept { return m_enabled; }
+
+/**
+ * @brief Marks the start of a frame.
+ *
+ * Zones opened before this call and after the end of the previous frame also
+ * belong to the new frame.
+ */
+void abcg::Profiler::beginFrame() {
+  std::scoped_lock const lock{m_mutex};
+  m_currentFrame.start = now();
+}
+
+/**
+ * @brief Marks the end of a frame and stores it in the history.
+ *
+ * Zones still open are closed at the end time of the frame.
+ */
+void abcg::Profiler::endFrame() {
+  std::scoped_lock const lock{m_mutex};
+  auto const frameEnd{now()};
+  m_currentFrame.end = frameEnd;
+  for (auto &zone : m_currentFrame.zones) {
+    if (zone.end < zone.start) {
+      zone.end = frameEnd;
+    }
+  }
+
+  auto &slot{m_history.at(m_numFrames % historySize)};
+  std::swap(slot, m_currentFrame);
+  ++m_numFrames;
+
+  // Reuse the storage of the oldest frame
+  m_currentFrame.zones.clear();
+  m_currentFrame.gpuZones.clear();
+  m_currentFrame.number = slot.number + 1;
+  m_currentFrame.start = frameEnd;
+  m_currentFrame.end = 0.0;
+}
+
+/**
+ * @brief Opens a zone in the current thread.
+ *
+ * @param name Name of the zone. Must have static storage duration, such as a
+ * string literal.
+ *
+ * @return Handle to be passed to abcg::Profiler::endZone.
+ */
+abcg::Profiler::ZoneHandle abcg::Profiler::beginZone(char const *name) {
+  if (!m_enabled)
+    return {};
+
+  std::scoped_lock const lock{m_mutex};
+  if (currentThreadIndex == UINT32_MAX) {
+    currentThreadIndex = m_numThreads++;
+  }
+
+  ZoneHandle const zone{m_currentFrame.number, m_currentFrame.zones.size()};
+  m_currentFrame.zones.push_back({.name = name,
+                                  .start = now(),
+                                  .end = -1.0,
+                                  .depth = currentThreadDepth++,
+                                  .thread = currentThreadIndex});
+  return zone;
+}
+
+/**
+ * @brief Closes a zone opened with abcg::Profiler::beginZone.
+ *
+ * Zones must be closed in the reverse order they were opened in the same
+ * thread.
+ *
+ * @param zone Handle returned by abcg::Profiler::beginZone.
+ */
+void abcg::Profiler::endZone(ZoneHandle const &zone) {
+  if (zone.index == SIZE_MAX)
+    return;
+
+  --currentThreadDepth;
+
+  std::scoped_lock const lock{m_mutex};
+  // Ignore zones that were closed by the end of their frame
+  if (zone.frame != m_currentFrame.number)
+    return;
+  m_currentFrame.zones.at(zone.index).end = now();
+}
+
+/**
+ * @brief Sets the GPU zones of a frame.
+ *
+ * This is called by the GPU profilers of the graphics backends when the
+ * timings of a frame become available.
+ *
+ * @param frameNumber Number of the frame the zones belong to. If the frame is
+ * no longer in the history, the zones are discarded.
+ * @param gpuZones GPU zones in the time base of the profiler.
+ */
+void abcg::Profiler::setGPUZones(std::uint64_t frameNumber,
+                                 std::vector<ProfilerZoneRecord> gpuZones) {
+  std::scoped_lock const lock{m_mutex};
+  if (frameNumber == m_currentFrame.number) {
+    m_currentFrame.gpuZones = std::move(gpuZones);
+    return;
+  }
+  for (auto &frame : m_history) {
+    if (frame.number == frameNumber && frame.end > 0.0) {
+      frame.gpuZones = std::move(gpuZones);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Returns the number of the frame being recorded.
+ */
+std::uint64_t abcg::Profiler::getCurrentFrameNumber() const {
+  std::scoped_lock const lock{m_mutex};
+  return m_currentFrame.number;
+}
+
+/**
+ * @brief Returns a copy of a frame of the history.
+ *
+ * @param framesAgo Position of the frame in the history, from the most recent
+ * frame (0) to the oldest frame (abcg::Profiler::historySize - 1).
+ *
+ * @return Copy of the frame, or an empty frame if there is no such frame.
+ */
+abcg::ProfilerFrame abcg::Profiler::getFrame(std::size_t framesAgo) const {
+  std::scoped_lock const lock{m_mutex};
+  if (framesAgo >= std::min(m_numFrames, historySize))
+    return {};
+  return m_history.at((m_numFrames - 1 - framesAgo) % historySize);
+}
+
+/**
+ * @brief Returns the number of frames recorded so far.
+ *
+ * Only the last abcg::Profiler::historySize frames are kept.
+ */
+std::size_t abcg::Profiler::getNumFrames() const noexcept {
+  std::scoped_lock const lock{m_mutex};
+  return m_numFrames;
+}
+
+/**
+ * @brief Returns the current time in the time base of the profiler.
+ *
+ * @return Time, in seconds, since the profiler was created.
+ */
+double abcg::Profiler::now() const {
+  return std::chrono::duration<double>(clock::now() - m_epoch).count();
+}
+
+/**
+ * @brief Draws the zones of a frame as a flame graph in the current ImGui
+ * window.
+ *
+ * Each zone is drawn as a bar whose horizontal extent corresponds to its
+ * time span within the frame. Nested zones are drawn below their parents, and
+ * zones of other threads are drawn below the zones of the main thread.
+ * Hovering a bar shows the name and duration of the zone.
+ *
+ * @param frame Frame to be drawn.
+ * @param width Width of the graph, in pixels.
+ */
+void abcg::Profiler::showFlameGraph(ProfilerFrame const &frame,
+                                    float const width) {
+  auto const duration{frame.end - frame.start};
+  if (frame.zones.empty() || duration <= 0.0)
+    return;
+
+  // First row of each thread, ordered by thread index
+  std::map<std::uint32_t, std::uint32_t> firstRow;
+  for (auto const &zone : frame.zones) {
+    auto &rows{firstRow[zone.thread]};
+    rows = std::max(rows, zone.depth + 1);
+  }
+  std::uint32_t numRows{};
+  for (auto &[thread, row] : firstRow) {
+    numRows += std::exchange(row, numRows);
+  }
+
+  // GPU zones are drawn below the CPU zones
+  auto const firstGPURow{numRows};
+  for (auto const &zone : frame.gpuZones) {
+    numRows = std::max(numRows, firstGPURow + zone.depth + 1);
+  }
+
+  auto const rowHeight{ImGui::GetTextLineHeight() + 2.0f};
+  auto const origin{ImGui::GetCursorScreenPos()};
+  ImGui::Dummy(ImVec2(width, rowHeight * gsl::narrow<float>(numRows)));
+
+  auto *drawList{ImGui::GetWindowDrawList()};
+  auto const toX{[&](double time) {
+    auto const ratio{std::clamp((time - frame.start) / duration, 0.0, 1.0)};
+    return origin.x + gsl::narrow_cast<float>(ratio) * width;
+  }};
+
+  auto const drawZone{[&](ProfilerZoneRecord const &zone, std::uint32_t row,
+                          char const *prefix) {
+    ImVec2 const min{toX(zone.start),
+                     origin.y + rowHeight * gsl::narrow<float>(row)};
+    ImVec2 const max{std::max(toX(zone.end), min.x + 1.0f),
+                     min.y + rowHeight - 1.0f};
+
+    // Color derived from the name
+    auto const hash{std::hash<std::string_view>{}(zone.name)};
+    auto const hue{gsl::narrow_cast<float>(hash % 360) / 360.0f};
+    drawList->AddRectFilled(min, max, ImColor::HSV(hue, 0.45f, 0.85f));
+
+    drawList->PushClipRect(min, max, true);
+    drawList->AddText(ImVec2(min.x + 2.0f, min.y), IM_COL32_BLACK, zone.name);
+    drawList->PopClipRect();
+
+    if (ImGui::IsMouseHoveringRect(min, max)) {
+      ImGui::SetTooltip("%s%s: %.3f ms", prefix, zone.name,
+                        (zone.end - zone.start) * 1000.0);
+    }
+  }};
+
+  for (auto const &zone : frame.zones) {
+    drawZone(zone, firstRow.at(zone.thread) + zone.depth, "");
+  }
+  for (auto const &zone : frame.gpuZones) {
+    drawZone(zone, firstGPURow + zone.depth, "GPU ");
+  }
+}
+
+/**
+ * @brief Opens a zone in abcg::Profiler.
+ *
+ * @param name Name of the zone. Must have static storage duration, such as a
+ * string literal.
+ */
+abcg::ProfilerZone::ProfilerZone(char const *name)
+    : m_zone{Profiler::getInstance().beginZone(name)} {}
+
+/**
+ * @brief Closes the zone.
+ */
+abcg::ProfilerZone::~ProfilerZone() { Profiler::getInstance().endZone(m_zone); }
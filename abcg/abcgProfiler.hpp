@@ -0,0 +1,172 @@
+/**
+ * @file abcgProfiler.hpp
+ * @brief Header file of abcg::Profiler.
+ *
+ * Declaration of abcg::Profiler and abcg::ProfilerZone classes, and of the
+ * ABCG_PROFILE_ZONE macro.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_PROFILER_HPP_
+#define ABCG_PROFILER_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "abcgExternal.hpp"
+
+namespace abcg {
+struct ProfilerZoneRecord;
+struct ProfilerFrame;
+class Profiler;
+class ProfilerZone;
+} // namespace abcg
+
+// @cond Skipped by Doxygen
+#define ABCG_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ABCG_PROFILE_CONCAT(a, b) ABCG_PROFILE_CONCAT_IMPL(a, b)
+// @endcond
+
+/**
+ * @brief Profiles the enclosing scope as a zone of the given name.
+ *
+ * @param name String literal with the name of the zone.
+ */
+#define ABCG_PROFILE_ZONE(name)                                                \
+  abcg::ProfilerZone const ABCG_PROFILE_CONCAT(abcgProfilerZone,               \
+                                               __LINE__) {                     \
+    name                                                                       \
+  }
+
+/**
+ * @brief Timing of a profiled zone.
+ */
+struct abcg::ProfilerZoneRecord {
+  /** @brief Name of the zone. Must have static storage duration. */
+  char const *name{};
+  /** @brief Start time, in seconds since the profiler was created. */
+  double start{};
+  /** @brief End time, in seconds since the profiler was created. */
+  double end{};
+  /** @brief Nesting level of the zone in its thread. Zero for root zones. */
+  std::uint32_t depth{};
+  /** @brief Index of the thread that recorded the zone. Zero for the first
+   * thread that recorded a zone, usually the main thread. */
+  std::uint32_t thread{};
+};
+
+/**
+ * @brief Zones recorded during a frame.
+ */
+struct abcg::ProfilerFrame {
+  /** @brief Sequential number of the frame. */
+  std::uint64_t number{};
+  /** @brief Start time, in seconds since the profiler was created. */
+  double start{};
+  /** @brief End time, in seconds since the profiler was created. */
+  double end{};
+  /** @brief Zones of the frame in the order they were opened. */
+  std::vector<ProfilerZoneRecord> zones;
+  /** @brief GPU zones of the frame, converted to the time base of the
+   * profiler.
+   *
+   * GPU timings are available only a few frames after the frame ends, so this
+   * is empty for the most recent frames. */
+  std::vector<ProfilerZoneRecord> gpuZones;
+};
+
+/**
+ * @brief Hierarchical CPU profiler.
+ *
+ * Records the start and end times of named zones, grouped by frame. The
+ * frames are delimited by abcg::Window, and the last
+ * abcg::Profiler::historySize frames are kept in a ring buffer.
+ *
+ * Zones are usually recorded with the ABCG_PROFILE_ZONE macro, which creates
+ * an abcg::ProfilerZone object that profiles the enclosing scope. Zones can be
+ * recorded from any thread and can be nested.
+ *
+ * abcg::OpenGLWindow and abcg::VulkanWindow record zones around the main
+ * phases of each frame and show the zones of the last frame in the FPS
+ * overlay window.
+ */
+class abcg::Profiler {
+public:
+  /** @brief Number of frames kept in the history. */
+  static constexpr std::size_t historySize{128};
+
+  static Profiler &getInstance();
+
+  void setEnabled(bool enabled) noexcept;
+  [[nodiscard]] bool isEnabled() const noexcept;
+
+  void beginFrame();
+  void endFrame();
+
+  /**
+   * @brief Identifies a zone opened with abcg::Profiler::beginZone.
+   */
+  struct ZoneHandle {
+    /** @brief Number of the frame the zone belongs to. */
+    std::uint64_t frame{};
+    /** @brief Index of the zone in the frame, or `SIZE_MAX` if the zone is
+     * not being recorded. */
+    std::size_t index{SIZE_MAX};
+  };
+
+  [[nodiscard]] ZoneHandle beginZone(char const *name);
+  void endZone(ZoneHandle const &zone);
+
+  void setGPUZones(std::uint64_t frameNumber,
+                   std::vector<ProfilerZoneRecord> gpuZones);
+
+  [[nodiscard]] ProfilerFrame getFrame(std::size_t framesAgo = 0) const;
+  [[nodiscard]] std::uint64_t getCurrentFrameNumber() const;
+  [[nodiscard]] std::size_t getNumFrames() const noexcept;
+  [[nodiscard]] double now() const;
+
+  static void showFlameGraph(ProfilerFrame const &frame, float width);
+
+private:
+  Profiler() = default;
+
+  using clock = std::chrono::steady_clock;
+
+  clock::time_point m_epoch{clock::now()};
+  std::atomic<bool> m_enabled{true};
+
+  mutable std::mutex m_mutex;
+  ProfilerFrame m_currentFrame;
+  std::array<ProfilerFrame, historySize> m_history{};
+  std::size_t m_numFrames{};
+  std::uint32_t m_numThreads{};
+};
+
+/**
+ * @brief Records a zone in abcg::Profiler during the lifetime of the object.
+ *
+ * @remark Objects of this type cannot be copied or moved.
+ */
+class abcg::ProfilerZone {
+public:
+  explicit ProfilerZone(char const *name);
+  ProfilerZone(ProfilerZone const &) = delete;
+  ProfilerZone(ProfilerZone &&) = delete;
+  ProfilerZone &operator=(ProfilerZone const &) = delete;
+  ProfilerZone &operator=(ProfilerZone &&) = delete;
+  ~ProfilerZone();
+
+private:
+  Profiler::ZoneHandle m_zone;
+};
+
+#endif
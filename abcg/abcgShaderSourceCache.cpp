@@ -0,0 +1,277 @@
+/**
+ * @file abcgShaderSourceCache.cpp
+ * @brief Definition of abcg::ShaderSourceCache members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgShaderSourceCache.hpp"
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <system_error>
+#include <utility>
+
+#include "abcgException.hpp"
+#include "abcgExternal.hpp"
+
+namespace {
+[[nodiscard]] std::string readFileContents(std::filesystem::path const &path) {
+#if defined(__linux__) || defined(__APPLE__)
+  auto const descriptor{open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+  if (descriptor < 0) {
+    throw abcg::RuntimeError(
+        fmt::format("Failed to read file {}", path.string()));
+  }
+  auto const closeFile{gsl::finally([descriptor] { close(descriptor); })};
+
+  struct stat status {};
+  if (fstat(descriptor, &status) != 0) {
+    throw abcg::RuntimeError(
+        fmt::format("Failed to read file {}", path.string()));
+  }
+  auto const size{gsl::narrow<std::size_t>(status.st_size)};
+  if (size == 0)
+    return {};
+
+  auto *data{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0)};
+  if (data == MAP_FAILED) {
+    throw abcg::RuntimeError(
+        fmt::format("Failed to read file {}", path.string()));
+  }
+  auto const unmapFile{gsl::finally([data, size] { munmap(data, size); })};
+  return {static_cast<char const *>(data), size};
+#else
+  std::ifstream stream(path, std::ios::binary | std::ios::ate);
+  if (!stream) {
+    throw abcg::RuntimeError(
+        fmt::format("Failed to read file {}", path.string()));
+  }
+  std::string contents(gsl::narrow<std::size_t>(stream.tellg()), '\0');
+  stream.seekg(0);
+  stream.read(contents.data(), gsl::narrow<std::streamsize>(contents.size()));
+  return contents;
+#endif
+}
+
+// Returns the file name of an #include directive, or std::nullopt if the line
+// is not an #include directive
+[[nodiscard]] std::optional<std::string_view>
+parseInclude(std::string_view line) {
+  auto const skipSpaces{[&line] {
+    while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) {
+      line.remove_prefix(1);
+    }
+  }};
+
+  skipSpaces();
+  if (!line.starts_with('#'))
+    return std::nullopt;
+  line.remove_prefix(1);
+  skipSpaces();
+  if (!line.starts_with("include"))
+    return std::nullopt;
+  line.remove_prefix(std::string_view{"include"}.size());
+  skipSpaces();
+  if (line.empty() || (line.front() != '"' && line.front() != '<'))
+    return std::nullopt;
+
+  auto const closing{line.front() == '"' ? '"' : '>'};
+  line.remove_prefix(1);
+  auto const end{line.find(closing)};
+  if (end == std::string_view::npos || end == 0)
+    return std::nullopt;
+  return line.substr(0, end);
+}
+} // namespace
+
+/**
+ * @brief Returns the shader source cache of the process.
+ *
+ * @returns Reference to the singleton object.
+ */
+abcg::ShaderSourceCache &abcg::ShaderSourceCache::getInstance() {
+  static ShaderSourceCache cache;
+  return cache;
+}
+
+/**
+ * @brief Returns the source code of a shader.
+ *
+ * @param pathOrSource Path of the shader file, or its source code. As in
+ * abcg::ShaderSource, the string is a path if a file with that name exists.
+ *
+ * @throw abcg::RuntimeError if a file could not be read, or if the includes
+ * are cyclic.
+ *
+ * @returns Source code with the includes resolved, or `pathOrSource` if it is
+ * not a path.
+ */
+std::shared_ptr<std::string const>
+abcg::ShaderSourceCache::load(std::string_view pathOrSource) {
+  std::scoped_lock const lock{m_mutex};
+
+  std::string key{pathOrSource};
+  if (auto const iter{m_shaders.find(key)}; iter != m_shaders.end())
+    return iter->second.source;
+
+  static constexpr std::size_t maxPathSize{260};
+  std::error_code error;
+  if (pathOrSource.size() > maxPathSize ||
+      !std::filesystem::exists(pathOrSource, error)) {
+    // Source code is not kept as a key, so that generated sources do not
+    // grow the cache. It is only shared with equal sources still in use.
+    return deduplicate(std::move(key));
+  }
+
+  auto const path{std::filesystem::absolute(pathOrSource).lexically_normal()};
+  Shader shader{.source = {}, .path = path.string(), .dependencies = {}};
+  std::string output;
+  std::vector<std::string> stack;
+  expand(path, 0, output, stack, shader.dependencies);
+  shader.source = deduplicate(std::move(output));
+
+  auto source{shader.source};
+  m_shaders.insert_or_assign(std::move(key), std::move(shader));
+  return source;
+}
+
+/**
+ * @brief Returns the files included by a shader file.
+ *
+ * @param path Path of the shader file, as passed to
+ * abcg::ShaderSourceCache::load.
+ *
+ * @returns Absolute paths of the files included directly or indirectly, in
+ * the order they were first included. The list is empty if the shader is not
+ * in the cache.
+ */
+std::vector<std::string>
+abcg::ShaderSourceCache::getDependencies(std::string_view path) const {
+  std::scoped_lock const lock{m_mutex};
+  auto const iter{m_shaders.find(std::string{path})};
+  return iter == m_shaders.end() ? std::vector<std::string>{}
+                                 : iter->second.dependencies;
+}
+
+/**
+ * @brief Removes a file from the cache, along with the shaders that include
+ * it.
+ *
+ * @param path Path of the file that changed.
+ */
+void abcg::ShaderSourceCache::invalidate(std::string_view path) {
+  std::scoped_lock const lock{m_mutex};
+  std::error_code error;
+  auto const absolutePath{
+      std::filesystem::absolute(path, error).lexically_normal().string()};
+  m_files.erase(absolutePath);
+  std::erase_if(m_shaders, [&absolutePath](auto const &entry) {
+    auto const &shader{entry.second};
+    return shader.path == absolutePath ||
+           std::ranges::find(shader.dependencies, absolutePath) !=
+               shader.dependencies.end();
+  });
+}
+
+/**
+ * @brief Removes all entries from the cache.
+ *
+ * Sources already returned by abcg::ShaderSourceCache::load remain valid.
+ */
+void abcg::ShaderSourceCache::clear() {
+  std::scoped_lock const lock{m_mutex};
+  m_shaders.clear();
+  m_files.clear();
+  m_sources.clear();
+  m_sourcesPruneThreshold = minSourcesPruneThreshold;
+}
+
+std::string const &
+abcg::ShaderSourceCache::readFile(std::filesystem::path const &path) {
+  auto key{path.string()};
+  if (auto const iter{m_files.find(key)}; iter != m_files.end())
+    return iter->second;
+  return m_files.emplace(std::move(key), readFileContents(path)).first->second;
+}
+
+// Appends the contents of a file to output with its includes resolved.
+// sourceIndex is the source string number of the file, stack holds the files
+// being expanded and dependencies the files included so far.
+void abcg::ShaderSourceCache::expand(std::filesystem::path const &path,
+                                     std::size_t const sourceIndex,
+                                     std::string &output,
+                                     std::vector<std::string> &stack,
+                                     std::vector<std::string> &dependencies) {
+  std::string_view remaining{readFile(path)};
+  stack.push_back(path.string());
+
+  std::size_t lineNumber{};
+  while (!remaining.empty()) {
+    auto const end{remaining.find('\n')};
+    auto const line{remaining.substr(0, end)};
+    remaining.remove_prefix(end == std::string_view::npos ? remaining.size()
+                                                          : end + 1);
+    ++lineNumber;
+
+    auto const include{parseInclude(line)};
+    if (!include) {
+      output.append(line);
+      output += '\n';
+      continue;
+    }
+
+    auto const includePath{(path.parent_path() / *include).lexically_normal()};
+    auto includeString{includePath.string()};
+    if (std::ranges::find(stack, includeString) != stack.end()) {
+      throw abcg::RuntimeError(fmt::format("Cyclic #include of {} in {}",
+                                           includeString, path.string()));
+    }
+    if (std::ranges::find(dependencies, includeString) !=
+        dependencies.end()) {
+      // Already included. Keep the line count.
+      output += '\n';
+      continue;
+    }
+
+    dependencies.push_back(std::move(includeString));
+    auto const includeIndex{dependencies.size()};
+    output += fmt::format("#line 1 {}\n", includeIndex);
+    expand(includePath, includeIndex, output, stack, dependencies);
+    output += fmt::format("#line {} {}\n", lineNumber + 1, sourceIndex);
+  }
+
+  stack.pop_back();
+}
+
+std::shared_ptr<std::string const>
+abcg::ShaderSourceCache::deduplicate(std::string source) {
+  auto &entry{m_sources[std::hash<std::string>{}(source)]};
+  if (auto existing{entry.lock()}; existing && *existing == source)
+    return existing;
+  auto result{std::make_shared<std::string const>(std::move(source))};
+  entry = result;
+
+  // Remove the entries of sources no longer in use, with a threshold that
+  // grows with the number of entries in use to keep insertions O(1) amortized
+  if (m_sources.size() > m_sourcesPruneThreshold) {
+    std::erase_if(m_sources,
+                  [](auto const &item) { return item.second.expired(); });
+    m_sourcesPruneThreshold =
+        std::max(minSourcesPruneThreshold, 2 * m_sources.size());
+  }
+  return result;
+}
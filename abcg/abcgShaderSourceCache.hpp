@@ -0,0 +1,92 @@
+/**
+ * @file abcgShaderSourceCache.hpp
+ * @brief Header file of abcg::ShaderSourceCache.
+ *
+ * Declaration of abcg::ShaderSourceCache class.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_SHADER_SOURCE_CACHE_HPP_
+#define ABCG_SHADER_SOURCE_CACHE_HPP_
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace abcg {
+class ShaderSourceCache;
+} // namespace abcg
+
+/**
+ * @brief Process-wide cache of shader source code read from files.
+ *
+ * Files are read once, by memory mapping where available. `#include "file"`
+ * directives are replaced by the contents of the file, relative to the
+ * directory of the file that includes it, followed by `#line` directives that
+ * restore the line numbers of the including file. The source string number of
+ * an included file is its 1-based index in
+ * abcg::ShaderSourceCache::getDependencies. Each file is included at most
+ * once in a shader, and cyclic includes are errors.
+ *
+ * Sources with the same contents share the same string. Source code passed
+ * instead of a path is not cached, but shares the string of equal sources
+ * that are still in use.
+ *
+ * Entries are not refreshed when files change. abcg::OpenGLProgram and
+ * abcg::VulkanShader call abcg::ShaderSourceCache::invalidate for the files
+ * reported by their hot reload watchers.
+ *
+ * @remark All functions are thread-safe.
+ */
+class abcg::ShaderSourceCache {
+public:
+  static ShaderSourceCache &getInstance();
+
+  [[nodiscard]] std::shared_ptr<std::string const>
+  load(std::string_view pathOrSource);
+  [[nodiscard]] std::vector<std::string>
+  getDependencies(std::string_view path) const;
+
+  void invalidate(std::string_view path);
+  void clear();
+
+private:
+  // Source of a shader file with its includes resolved
+  struct Shader {
+    std::shared_ptr<std::string const> source;
+    // Absolute path of the file
+    std::string path;
+    // Absolute paths of the files included directly or indirectly
+    std::vector<std::string> dependencies;
+  };
+
+  [[nodiscard]] std::string const &
+  readFile(std::filesystem::path const &path);
+  void expand(std::filesystem::path const &path, std::size_t sourceIndex,
+              std::string &output, std::vector<std::string> &stack,
+              std::vector<std::string> &dependencies);
+  [[nodiscard]] std::shared_ptr<std::string const>
+  deduplicate(std::string source);
+
+  mutable std::mutex m_mutex;
+  // Shaders read from files, by the path used to load them
+  std::unordered_map<std::string, Shader> m_shaders;
+  // Contents of files as read from disk, by absolute path
+  std::unordered_map<std::string, std::string> m_files;
+  // Sources handed out, by hash of their contents
+  std::unordered_map<std::size_t, std::weak_ptr<std::string const>> m_sources;
+  // Number of entries of m_sources above which expired entries are removed
+  static constexpr std::size_t minSourcesPruneThreshold{64};
+  std::size_t m_sourcesPruneThreshold{minSourcesPruneThreshold};
+};
+
+#endif
@@ -0,0 +1,192 @@
+/**
+ * @file abcgTraceExporter.cpp
+ * @brief Definition of abcg::TraceExporter members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgTraceExporter.hpp"
+
+#include <fmt/format.h>
+
+#include <string_view>
+
+#include "abcgException.hpp"
+
+namespace {
+// Track IDs. CPU threads use their profiler thread index plus one
+constexpr std::uint32_t frameTrackID{0};
+constexpr std::uint32_t gpuTrackID{1000000};
+
+// Escapes a string to be used in a JSON string literal
+std::string escapeJSON(std::string_view text) {
+  std::string escaped;
+  escaped.reserve(text.size());
+  for (auto const character : text) {
+    switch (character) {
+    case '"':
+      escaped += "\\\"";
+      break;
+    case '\\':
+      escaped += "\\\\";
+      break;
+    default:
+      if (static_cast<unsigned char>(character) < 0x20) {
+        escaped += fmt::format("\\u{:04x}", static_cast<int>(character));
+      } else {
+        escaped += character;
+      }
+    }
+  }
+  return escaped;
+}
+
+// Converts seconds to microseconds, the time unit of the trace format
+double toMicroseconds(double seconds) { return seconds * 1e6; }
+} // namespace
+
+/**
+ * @brief Creates the trace file and starts the writer thread.
+ *
+ * @param filename Path of the JSON file. An existing file is overwritten.
+ *
+ * @throw abcg::RuntimeError if the file cannot be created.
+ */
+abcg::TraceExporter::TraceExporter(std::string const &filename)
+    : m_file{filename, std::ios::out | std::ios::trunc} {
+  if (!m_file) {
+    throw abcg::RuntimeError(
+        fmt::format("Failed to create trace file {}", filename));
+  }
+
+  m_file << R"({"displayTimeUnit":"ms","traceEvents":[)" << '\n';
+  m_writer = std::thread{&TraceExporter::writerLoop, this};
+
+  fmt::print("Writing trace..: {}\n", filename);
+}
+
+/**
+ * @brief Exports the remaining frames of the history, and closes the file.
+ */
+abcg::TraceExporter::~TraceExporter() {
+  collectFrames(0);
+  {
+    std::scoped_lock const lock{m_mutex};
+    m_stop = true;
+  }
+  m_condition.notify_all();
+  m_writer.join();
+
+  m_file << "\n]}\n";
+}
+
+/**
+ * @brief Queues for writing the frames that are old enough to be exported.
+ *
+ * This is called by abcg::Window at the end of each frame.
+ */
+void abcg::TraceExporter::update() { collectFrames(frameDelay); }
+
+void abcg::TraceExporter::collectFrames(std::size_t delay) {
+  auto const &profiler{Profiler::getInstance()};
+  auto const numFrames{profiler.getNumFrames()};
+
+  std::vector<ProfilerFrame> frames;
+  while (m_numExportedFrames + delay < numFrames) {
+    auto const framesAgo{numFrames - 1 - m_numExportedFrames};
+    if (framesAgo < Profiler::historySize) {
+      frames.push_back(profiler.getFrame(framesAgo));
+    }
+    // Frames that left the history are skipped
+    ++m_numExportedFrames;
+  }
+  if (frames.empty())
+    return;
+
+  {
+    std::scoped_lock const lock{m_mutex};
+    for (auto &frame : frames) {
+      m_queue.push_back(std::move(frame));
+    }
+  }
+  m_condition.notify_one();
+}
+
+void abcg::TraceExporter::writerLoop() {
+  while (true) {
+    std::vector<ProfilerFrame> frames;
+    auto stop{false};
+    {
+      std::unique_lock lock{m_mutex};
+      m_condition.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+      std::swap(frames, m_queue);
+      stop = m_stop;
+    }
+
+    for (auto const &frame : frames) {
+      writeFrame(frame);
+    }
+    m_file.flush();
+
+    if (stop)
+      return;
+  }
+}
+
+void abcg::TraceExporter::writeFrame(ProfilerFrame const &frame) {
+  std::string events;
+
+  auto const addEvent{[&](std::string const &event) {
+    if (!m_firstEvent) {
+      events += ",\n";
+    }
+    m_firstEvent = false;
+    events += event;
+  }};
+
+  auto const nameTrack{[&](std::uint32_t trackID, std::string_view name) {
+    if (m_namedThreads.insert(trackID).second) {
+      addEvent(fmt::format(R"({{"name":"thread_name","ph":"M","pid":1,)"
+                           R"("tid":{},"args":{{"name":"{}"}}}})",
+                           trackID, escapeJSON(name)));
+      addEvent(fmt::format(R"({{"name":"thread_sort_index","ph":"M","pid":1,)"
+                           R"("tid":{},"args":{{"sort_index":{}}}}})",
+                           trackID, trackID));
+    }
+  }};
+
+  auto const addZone{[&](ProfilerZoneRecord const &zone, std::uint32_t trackID,
+                         std::string_view category) {
+    addEvent(fmt::format(R"({{"name":"{}","cat":"{}","ph":"X","ts":{:.3f},)"
+                         R"("dur":{:.3f},"pid":1,"tid":{}}})",
+                         escapeJSON(zone.name), category,
+                         toMicroseconds(zone.start),
+                         toMicroseconds(zone.end - zone.start), trackID));
+  }};
+
+  nameTrack(frameTrackID, "Frames");
+  addEvent(fmt::format(R"({{"name":"Frame {}","cat":"frame","ph":"X",)"
+                       R"("ts":{:.3f},"dur":{:.3f},"pid":1,"tid":{}}})",
+                       frame.number, toMicroseconds(frame.start),
+                       toMicroseconds(frame.end - frame.start), frameTrackID));
+
+  for (auto const &zone : frame.zones) {
+    auto const trackID{zone.thread + 1};
+    nameTrack(trackID, zone.thread == 0
+                           ? std::string{"Main thread"}
+                           : fmt::format("Thread {}", zone.thread));
+    addZone(zone, trackID, "cpu");
+  }
+
+  if (!frame.gpuZones.empty()) {
+    nameTrack(gpuTrackID, "GPU");
+  }
+  for (auto const &zone : frame.gpuZones) {
+    addZone(zone, gpuTrackID, "gpu");
+  }
+
+  m_file << events;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file abcgTraceExporter.hpp
+ * @brief Header file of abcg::TraceExporter.
+ *
+ * Declaration of abcg::TraceExporter class.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_TRACE_EXPORTER_HPP_
+#define ABCG_TRACE_EXPORTER_HPP_
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "abcgProfiler.hpp"
+
+namespace abcg {
+class TraceExporter;
+} // namespace abcg
+
+/**
+ * @brief Writes the frames recorded by abcg::Profiler to a JSON file in the
+ * Trace Event Format.
+ *
+ * The file can be opened in `chrome://tracing` or in the Perfetto UI
+ * (https://ui.perfetto.dev). Each CPU thread and the GPU are shown as separate
+ * tracks, and frames are shown in a track of their own.
+ *
+ * Frames are exported with a delay of abcg::TraceExporter::frameDelay frames,
+ * so that their GPU timings are already available. The JSON text is written
+ * by a background thread.
+ *
+ * abcg::Window creates an exporter if abcg::WindowSettings::traceFile or the
+ * environment variable `ABCG_TRACE_FILE` is set.
+ *
+ * @remark Objects of this type cannot be copied or moved.
+ */
+class abcg::TraceExporter {
+public:
+  /** @brief Number of frames to wait before exporting a frame. */
+  static constexpr std::size_t frameDelay{Profiler::historySize / 2};
+
+  explicit TraceExporter(std::string const &filename);
+  TraceExporter(TraceExporter const &) = delete;
+  TraceExporter(TraceExporter &&) = delete;
+  TraceExporter &operator=(TraceExporter const &) = delete;
+  TraceExporter &operator=(TraceExporter &&) = delete;
+  ~TraceExporter();
+
+  void update();
+
+private:
+  void collectFrames(std::size_t delay);
+  void writerLoop();
+  void writeFrame(ProfilerFrame const &frame);
+
+  std::ofstream m_file;
+  std::uint64_t m_numExportedFrames{};
+  bool m_firstEvent{true};
+  std::set<std::uint32_t> m_namedThreads;
+
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::vector<ProfilerFrame> m_queue;
+  bool m_stop{};
+  std::thread m_writer;
+};
+
+#endif
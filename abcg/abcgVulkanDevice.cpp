@@ -12,11 +12,103 @@
 
 #include <gsl/gsl>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <set>
+#include <system_error>
+#include <utility>
 
+namespace {
+// Header of the data of a pipeline cache, as defined by
+// VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+struct PipelineCacheHeader {
+  uint32_t headerSize{};
+  uint32_t headerVersion{};
+  uint32_t vendorID{};
+  uint32_t deviceID{};
+  std::array<uint8_t, VK_UUID_SIZE> pipelineCacheUUID{};
+};
+
+// Reads the data of a pipeline cache. Returns an empty vector if the file does
+// not exist or was not created by the same driver and device.
+[[nodiscard]] std::vector<char>
+loadPipelineCacheData(std::filesystem::path const &path,
+                      vk::PhysicalDeviceProperties const &properties) {
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream)
+    return {};
+  std::vector<char> data{std::istreambuf_iterator<char>{stream},
+                         std::istreambuf_iterator<char>{}};
+
+  PipelineCacheHeader header;
+  if (data.size() < sizeof(header))
+    return {};
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (header.headerSize < sizeof(header) ||
+      header.headerSize > data.size() ||
+      header.headerVersion !=
+          static_cast<uint32_t>(vk::PipelineCacheHeaderVersion::eOne) ||
+      header.vendorID != properties.vendorID ||
+      header.deviceID != properties.deviceID ||
+      !std::ranges::equal(header.pipelineCacheUUID,
+                          properties.pipelineCacheUUID)) {
+    return {};
+  }
+  return data;
+}
+
+// Writes the data of a pipeline cache. Errors are ignored, as the pipelines
+// are then compiled again in the next run.
+void savePipelineCacheData(std::filesystem::path const &path,
+                           std::vector<uint8_t> const &data) {
+  std::error_code errorCode;
+  std::filesystem::create_directories(path.parent_path(), errorCode);
+  if (errorCode)
+    return;
+
+  // Write to a temporary file first so that a partially written file is never
+  // read
+  auto tempPath{path};
+  tempPath += ".tmp";
+  {
+    std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<char const *>(data.data()),
+                 gsl::narrow<std::streamsize>(data.size()));
+    if (!stream) {
+      stream.close();
+      std::filesystem::remove(tempPath, errorCode);
+      return;
+    }
+  }
+  std::filesystem::rename(tempPath, path, errorCode);
+  if (errorCode) {
+    std::filesystem::remove(tempPath, errorCode);
+  }
+}
+} // namespace
+
+/**
+ * @brief Creates the logical device and its queues, command pools, and
+ * pipeline cache.
+ *
+ * @param physicalDevice Physical device.
+ * @param extensions Names of the device extensions to enable.
+ * @param pipelineCachePath Path of the file of the pipeline cache. The cache
+ * is initialized from the file if the file was saved by the same driver and
+ * device, as identified by the `pipelineCacheUUID`, vendor and device IDs of
+ * its header. Otherwise, the cache starts empty. The cache is saved to the
+ * file by abcg::VulkanDevice::destroy. If the path is empty, the cache is not
+ * persisted.
+ */
 void abcg::VulkanDevice::create(VulkanPhysicalDevice const &physicalDevice,
-                                std::vector<char const *> const &extensions) {
+                                std::vector<char const *> const &extensions,
+                                std::string pipelineCachePath) {
   m_physicalDevice = physicalDevice;
+  m_pipelineCachePath = std::move(pipelineCachePath);
   auto const &queuesFamilies{m_physicalDevice.getQueuesFamilies()};
   auto const graphicsQueueFamily{queuesFamilies.graphics.value_or(0)};
   auto const presentQueueFamily{queuesFamilies.present.value_or(0)};
@@ -66,9 +158,15 @@ void abcg::VulkanDevice::create(VulkanPhysicalDevice const &physicalDevice,
   }
 
   createCommandPools();
+  createPipelineCache();
 }
 
+/**
+ * @brief Saves the pipeline cache, if persisted, and destroys the logical
+ * device and its resources.
+ */
 void abcg::VulkanDevice::destroy() {
+  destroyPipelineCache();
   destroyCommandPools();
   m_device.destroy();
 }
@@ -109,6 +207,19 @@ abcg::VulkanDevice::getCommandPools() const noexcept {
   return m_commandPools;
 }
 
+/**
+ * @brief Returns the pipeline cache of this device.
+ *
+ * abcg::VulkanPipeline::create uses this cache if
+ * abcg::VulkanPipelineCreateInfo::pipelineCache is null.
+ *
+ * @return Pipeline cache.
+ */
+vk::PipelineCache const &
+abcg::VulkanDevice::getPipelineCache() const noexcept {
+  return m_pipelineCache;
+}
+
 /**
  * @brief Allocates and creates a command buffer to be immediately submitted and
  * released.
@@ -213,3 +324,23 @@ void abcg::VulkanDevice::destroyCommandPools() {
 
   m_device.destroyCommandPool(m_commandPools.graphics);
 }
+
+void abcg::VulkanDevice::createPipelineCache() {
+  std::vector<char> data;
+  if (!m_pipelineCachePath.empty()) {
+    data = loadPipelineCacheData(
+        m_pipelineCachePath,
+        static_cast<vk::PhysicalDevice>(m_physicalDevice).getProperties());
+  }
+  m_pipelineCache = m_device.createPipelineCache(
+      {.initialDataSize = data.size(), .pInitialData = data.data()});
+}
+
+void abcg::VulkanDevice::destroyPipelineCache() {
+  if (!m_pipelineCachePath.empty() && m_pipelineCache) {
+    savePipelineCacheData(m_pipelineCachePath,
+                          m_device.getPipelineCacheData(m_pipelineCache));
+  }
+  m_device.destroyPipelineCache(m_pipelineCache);
+  m_pipelineCache = nullptr;
+}
@@ -16,6 +16,7 @@
 #include "abcgVulkanPhysicalDevice.hpp"
 
 #include <functional>
+#include <string>
 
 namespace abcg {
 struct VulkanCommandPools;
@@ -50,12 +51,13 @@ struct abcg::VulkanQueues {
  * resources.
  *
  * This class creates and manages the Vulkan logical device, queues, descriptor
- * pool, and command pools.
+ * pool, command pools, and pipeline cache.
  */
 class abcg::VulkanDevice {
 public:
   void create(VulkanPhysicalDevice const &physicalDevice,
-              std::vector<char const *> const &extensions = {});
+              std::vector<char const *> const &extensions = {},
+              std::string pipelineCachePath = {});
   void destroy();
 
   explicit operator vk::Device const &() const noexcept;
@@ -63,6 +65,7 @@ public:
   [[nodiscard]] VulkanPhysicalDevice const &getPhysicalDevice() const noexcept;
   [[nodiscard]] VulkanQueues const &getQueues() const noexcept;
   [[nodiscard]] VulkanCommandPools const &getCommandPools() const noexcept;
+  [[nodiscard]] vk::PipelineCache const &getPipelineCache() const noexcept;
 
   void withCommandBuffer(
       std::function<void(vk::CommandBuffer const &commandBuffer)> const &fun,
@@ -72,11 +75,16 @@ public:
 private:
   void createCommandPools();
   void destroyCommandPools();
+  void createPipelineCache();
+  void destroyPipelineCache();
 
   vk::Device m_device;
   VulkanPhysicalDevice m_physicalDevice;
   VulkanCommandPools m_commandPools;
   VulkanQueues m_queues;
+  vk::PipelineCache m_pipelineCache;
+  // File of the pipeline cache. The cache is not persisted if empty.
+  std::string m_pipelineCachePath;
 };
 
 #endif
\ No newline at end of file
@@ -10,24 +10,62 @@
 
 #include "abcgVulkanPipeline.hpp"
 
+#include <cppitertools/itertools.hpp>
 #include <gsl/gsl>
 
-void abcg::VulkanPipeline::create(VulkanSwapchain const &swapchain,
-                                  VulkanPipelineCreateInfo const &createInfo) {
-  m_device = static_cast<vk::Device>(swapchain.getDevice());
+#include <deque>
+#include <utility>
+
+#include "abcgVulkanError.hpp"
+
+namespace {
+// Fixed-function state of a graphics pipeline, with the defaults of
+// abcg::VulkanPipelineCreateInfo resolved. The pointers of the create info
+// refer to the members of this object, which therefore cannot be moved.
+class GraphicsPipelineState {
+public:
+  GraphicsPipelineState(abcg::VulkanSwapchain const &swapchain,
+                        abcg::VulkanPipelineCreateInfo const &createInfo);
+  GraphicsPipelineState(GraphicsPipelineState const &) = delete;
+  GraphicsPipelineState(GraphicsPipelineState &&) = delete;
+  GraphicsPipelineState &operator=(GraphicsPipelineState const &) = delete;
+  GraphicsPipelineState &operator=(GraphicsPipelineState &&) = delete;
+  ~GraphicsPipelineState() = default;
+
+  [[nodiscard]] vk::GraphicsPipelineCreateInfo
+  getCreateInfo(vk::PipelineLayout layout) const;
+
+private:
+  abcg::VulkanPipelineCreateInfo const &m_createInfo;
+  vk::RenderPass m_renderPass;
+  std::vector<vk::PipelineShaderStageCreateInfo> m_shaderStages;
+  vk::PipelineVertexInputStateCreateInfo m_vertexInputState;
+  std::vector<vk::Viewport> m_viewports;
+  std::vector<vk::Rect2D> m_scissors;
+  vk::PipelineViewportStateCreateInfo m_viewportState;
+  vk::PipelineMultisampleStateCreateInfo m_multisampleState;
+  vk::PipelineDepthStencilStateCreateInfo m_depthStencilState;
+  vk::PipelineColorBlendAttachmentState m_colorBlendAttachment;
+  vk::PipelineColorBlendStateCreateInfo m_colorBlendState;
+  vk::PipelineDynamicStateCreateInfo m_dynamicState;
+};
+
+GraphicsPipelineState::GraphicsPipelineState(
+    abcg::VulkanSwapchain const &swapchain,
+    abcg::VulkanPipelineCreateInfo const &createInfo)
+    : m_createInfo{createInfo}, m_renderPass{swapchain.getMainRenderPass()} {
   auto const &physicalDevice{swapchain.getDevice().getPhysicalDevice()};
 
   // Shader stages
-  std::vector<vk::PipelineShaderStageCreateInfo> shaderStages;
-  shaderStages.reserve(createInfo.shaders.size());
+  m_shaderStages.reserve(createInfo.shaders.size());
   for (auto const &shader : createInfo.shaders) {
-    shaderStages.push_back({.stage = shader.getStage(),
-                            .module = shader.getModule(),
-                            .pName = "main"});
+    m_shaderStages.push_back({.stage = shader.getStage(),
+                              .module = shader.getModule(),
+                              .pName = "main"});
   }
 
   // Vertex binding and attributes
-  vk::PipelineVertexInputStateCreateInfo const vertexInputState{
+  m_vertexInputState = {
       .vertexBindingDescriptionCount =
           gsl::narrow<uint32_t>(createInfo.bindingDescriptions.size()),
       .pVertexBindingDescriptions = createInfo.bindingDescriptions.data(),
@@ -36,93 +74,224 @@ void abcg::VulkanPipeline::create(VulkanSwapchain const &swapchain,
       .pVertexAttributeDescriptions = createInfo.attributeDescriptions.data()};
 
   // Viewport state
-  auto viewports{createInfo.viewports.value_or(std::vector<vk::Viewport>{
+  m_viewports = createInfo.viewports.value_or(std::vector<vk::Viewport>{
       {.width = gsl::narrow<float>(swapchain.getExtent().width),
        .height = gsl::narrow<float>(swapchain.getExtent().height),
        .minDepth = 0,
-       .maxDepth = 1}})};
-  auto scissors{createInfo.scissors.value_or(
-      std::vector<vk::Rect2D>{{.extent = swapchain.getExtent()}})};
-  vk::PipelineViewportStateCreateInfo const viewportState{
-      .viewportCount = gsl::narrow<uint32_t>(viewports.size()),
-      .pViewports = viewports.data(),
-      .scissorCount = gsl::narrow<uint32_t>(scissors.size()),
-      .pScissors = scissors.data()};
+       .maxDepth = 1}});
+  m_scissors = createInfo.scissors.value_or(
+      std::vector<vk::Rect2D>{{.extent = swapchain.getExtent()}});
+  m_viewportState = {.viewportCount = gsl::narrow<uint32_t>(m_viewports.size()),
+                     .pViewports = m_viewports.data(),
+                     .scissorCount = gsl::narrow<uint32_t>(m_scissors.size()),
+                     .pScissors = m_scissors.data()};
 
   // Multisampling
-  vk::PipelineMultisampleStateCreateInfo multisampleState{};
   if (createInfo.multisampleState.has_value()) {
-    multisampleState = createInfo.multisampleState.value();
+    m_multisampleState = createInfo.multisampleState.value();
   } else {
     auto sampleCount{physicalDevice.getSampleCount()};
-    multisampleState.rasterizationSamples = sampleCount;
+    m_multisampleState.rasterizationSamples = sampleCount;
     if (sampleCount > vk::SampleCountFlagBits::e1) {
       // Enable sample shading if available
       if (static_cast<vk::PhysicalDevice>(physicalDevice)
               .getFeatures()
               .sampleRateShading == VK_TRUE) {
-        multisampleState.sampleShadingEnable = VK_TRUE;
-        multisampleState.minSampleShading = 0.5f;
+        m_multisampleState.sampleShadingEnable = VK_TRUE;
+        m_multisampleState.minSampleShading = 0.5f;
       }
     }
   }
 
   // Depth and stencil
-  vk::PipelineDepthStencilStateCreateInfo depthStencilState{};
   if (createInfo.depthStencilState.has_value()) {
-    depthStencilState = createInfo.depthStencilState.value();
+    m_depthStencilState = createInfo.depthStencilState.value();
   } else {
     if (static_cast<vk::Image>(swapchain.getDepthImage())) {
-      depthStencilState = {.depthTestEnable = VK_TRUE,
-                           .depthWriteEnable = VK_TRUE,
-                           .depthCompareOp = vk::CompareOp::eLess};
+      m_depthStencilState = {.depthTestEnable = VK_TRUE,
+                             .depthWriteEnable = VK_TRUE,
+                             .depthCompareOp = vk::CompareOp::eLess};
     }
   }
 
   // Color blending
-  auto colorBlendAttachment{createInfo.colorBlendAttachment.value_or(
+  m_colorBlendAttachment = createInfo.colorBlendAttachment.value_or(
       vk::PipelineColorBlendAttachmentState{
           .blendEnable = VK_FALSE,
           .colorWriteMask = vk::ColorComponentFlagBits::eR |
                             vk::ColorComponentFlagBits::eG |
                             vk::ColorComponentFlagBits::eB |
-                            vk::ColorComponentFlagBits::eA})};
-  auto colorBlendState{
+                            vk::ColorComponentFlagBits::eA});
+  m_colorBlendState =
       createInfo.colorBlendState.value_or(vk::PipelineColorBlendStateCreateInfo{
           .logicOpEnable = VK_FALSE,
           .attachmentCount = 1,
-          .pAttachments = &colorBlendAttachment})};
+          .pAttachments = &m_colorBlendAttachment});
 
   // Dynamic state
-  vk::PipelineDynamicStateCreateInfo const dynamicState{
-      .dynamicStateCount =
-          gsl::narrow<uint32_t>(createInfo.dynamicStates.size()),
-      .pDynamicStates = createInfo.dynamicStates.data()};
-
-  // Pipeline layout
-  m_pipelineLayout = m_device.createPipelineLayout(createInfo.pipelineLayout);
-
-  vk::GraphicsPipelineCreateInfo const pipelineCreateInfo{
-      .stageCount = gsl::narrow<uint32_t>(shaderStages.size()),
-      .pStages = shaderStages.data(),
-      .pVertexInputState = &vertexInputState,
-      .pInputAssemblyState = &createInfo.inputAssemblyState,
-      .pViewportState = &viewportState,
-      .pRasterizationState = &createInfo.rasterizationState,
-      .pMultisampleState = &multisampleState,
-      .pDepthStencilState = &depthStencilState,
-      .pColorBlendState = &colorBlendState,
-      .pDynamicState = &dynamicState,
-      .layout = m_pipelineLayout,
-      .renderPass = swapchain.getMainRenderPass(),
-      .subpass = 0
-      // .basePipelineHandle = VK_NULL_HANDLE,
-      // .basePipelineIndex = -1
+  m_dynamicState = {.dynamicStateCount =
+                        gsl::narrow<uint32_t>(createInfo.dynamicStates.size()),
+                    .pDynamicStates = createInfo.dynamicStates.data()};
+}
+
+vk::GraphicsPipelineCreateInfo
+GraphicsPipelineState::getCreateInfo(vk::PipelineLayout layout) const {
+  return {.stageCount = gsl::narrow<uint32_t>(m_shaderStages.size()),
+          .pStages = m_shaderStages.data(),
+          .pVertexInputState = &m_vertexInputState,
+          .pInputAssemblyState = &m_createInfo.inputAssemblyState,
+          .pViewportState = &m_viewportState,
+          .pRasterizationState = &m_createInfo.rasterizationState,
+          .pMultisampleState = &m_multisampleState,
+          .pDepthStencilState = &m_depthStencilState,
+          .pColorBlendState = &m_colorBlendState,
+          .pDynamicState = &m_dynamicState,
+          .layout = layout,
+          .renderPass = m_renderPass,
+          .subpass = 0
+          // .basePipelineHandle = VK_NULL_HANDLE,
+          // .basePipelineIndex = -1
   };
+}
+} // namespace
+
+/**
+ * @brief Creates the pipeline and its layout.
+ *
+ * @param swapchain Swapchain whose main render pass is used by the pipeline.
+ * @param createInfo Creation info. If its pipeline cache is null, the pipeline
+ * cache of the device is used.
+ */
+void abcg::VulkanPipeline::create(VulkanSwapchain const &swapchain,
+                                  VulkanPipelineCreateInfo const &createInfo) {
+  *this = std::move(createPipelines(swapchain, {&createInfo, 1}).front());
+}
+
+/**
+ * @brief Creates several pipelines with a single call to
+ * vk::Device::createGraphicsPipelines per pipeline cache.
+ *
+ * Creating the pipelines together lets the driver compile them in parallel.
+ * Pipelines whose creation info has a null pipeline cache share the pipeline
+ * cache of the device.
+ *
+ * @param swapchain Swapchain whose main render pass is used by the pipelines.
+ * @param createInfos Creation info of each pipeline.
+ *
+ * @throw abcg::VulkanError if the creation of any pipeline has failed. The
+ * pipelines and layouts already created are destroyed in this case.
+ *
+ * @return Pipelines in the same order as @a createInfos.
+ */
+std::vector<abcg::VulkanPipeline> abcg::VulkanPipeline::createMany(
+    VulkanSwapchain const &swapchain,
+    std::vector<VulkanPipelineCreateInfo> const &createInfos) {
+  return createPipelines(swapchain, createInfos);
+}
+
+/**
+ * @brief Creates several pipelines on a background thread.
+ *
+ * The pipelines are created as in abcg::VulkanPipeline::createMany, so that
+ * the calling thread (e.g., in abcg::VulkanWindow::onCreate) can render other
+ * frames while the driver compiles them.
+ *
+ * @param swapchain Swapchain whose main render pass is used by the pipelines.
+ * It must not be destroyed or rebuilt until the future is ready.
+ * @param createInfos Creation info of each pipeline. The data pointed to by
+ * its Vulkan structures, such as the descriptor set layouts of the pipeline
+ * layout, must remain valid until the future is ready.
+ *
+ * @return Future of the pipelines in the same order as @a createInfos. The
+ * future rethrows the exception thrown by the creation, if any.
+ */
+std::future<std::vector<abcg::VulkanPipeline>>
+abcg::VulkanPipeline::createManyAsync(
+    VulkanSwapchain const &swapchain,
+    std::vector<VulkanPipelineCreateInfo> createInfos) {
+  return std::async(std::launch::async,
+                    [&swapchain, createInfos = std::move(createInfos)] {
+                      return createPipelines(swapchain, createInfos);
+                    });
+}
+
+std::vector<abcg::VulkanPipeline> abcg::VulkanPipeline::createPipelines(
+    VulkanSwapchain const &swapchain,
+    std::span<VulkanPipelineCreateInfo const> createInfos) {
+  auto const &device{swapchain.getDevice()};
+  auto const vkDevice{static_cast<vk::Device>(device)};
+
+  std::vector<VulkanPipeline> pipelines(createInfos.size());
+  auto const destroyOnFailure{[&pipelines, vkDevice] {
+    for (auto const &pipeline : pipelines) {
+      vkDevice.destroyPipeline(pipeline.m_pipeline);
+      vkDevice.destroyPipelineLayout(pipeline.m_pipelineLayout);
+    }
+  }};
+
+  try {
+    // States are kept in a deque as they cannot be moved
+    std::deque<GraphicsPipelineState> states;
+    for (auto const index : iter::range(createInfos.size())) {
+      auto const &createInfo{createInfos[index]};
+      auto &pipeline{pipelines.at(index)};
+      pipeline.m_device = vkDevice;
+      pipeline.m_pipelineLayout =
+          vkDevice.createPipelineLayout(createInfo.pipelineLayout);
+      states.emplace_back(swapchain, createInfo);
+    }
+
+    // Use the pipeline cache of the device by default, and create the
+    // pipelines that share a cache with a single call
+    auto const getPipelineCache{[&](std::size_t index) {
+      auto const &cache{createInfos[index].pipelineCache};
+      return cache ? cache : device.getPipelineCache();
+    }};
+    std::vector<bool> created(createInfos.size());
+    for (auto const first : iter::range(createInfos.size())) {
+      if (created.at(first))
+        continue;
+      auto const pipelineCache{getPipelineCache(first)};
+
+      std::vector<std::size_t> indices;
+      std::vector<vk::GraphicsPipelineCreateInfo> pipelineCreateInfos;
+      for (auto const index : iter::range(first, createInfos.size())) {
+        if (!created.at(index) && getPipelineCache(index) == pipelineCache) {
+          created.at(index) = true;
+          indices.push_back(index);
+          pipelineCreateInfos.push_back(states.at(index).getCreateInfo(
+              pipelines.at(index).m_pipelineLayout));
+        }
+      }
+
+      // Call the C function, as Vulkan-Hpp throws on failure without
+      // returning the pipelines that were created by the same call
+      std::vector<VkPipeline> handles(pipelineCreateInfos.size(),
+                                      VK_NULL_HANDLE);
+      auto const result{vkCreateGraphicsPipelines(
+          static_cast<VkDevice>(vkDevice),
+          static_cast<VkPipelineCache>(pipelineCache),
+          gsl::narrow<uint32_t>(pipelineCreateInfos.size()),
+          reinterpret_cast<VkGraphicsPipelineCreateInfo const *>(
+              pipelineCreateInfos.data()),
+          nullptr, handles.data())};
+
+      // Store the pipelines before checking the result, so that they are
+      // destroyed if the call failed
+      for (auto const index : iter::range(indices.size())) {
+        pipelines.at(indices.at(index)).m_pipeline =
+            vk::Pipeline{handles.at(index)};
+      }
+      if (result < 0) {
+        throw abcg::VulkanError(result);
+      }
+    }
+  } catch (...) {
+    destroyOnFailure();
+    throw;
+  }
 
-  auto result{m_device.createGraphicsPipeline(createInfo.pipelineCache,
-                                              pipelineCreateInfo)};
-  m_pipeline = result.value;
+  return pipelines;
 }
 
 void abcg::VulkanPipeline::destroy() {
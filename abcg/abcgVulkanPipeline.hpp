@@ -13,6 +13,10 @@
 #ifndef ABCG_VULKAN_PIPELINE_HPP_
 #define ABCG_VULKAN_PIPELINE_HPP_
 
+#include <future>
+#include <span>
+#include <vector>
+
 #include "abcgVulkanShader.hpp"
 #include "abcgVulkanSwapchain.hpp"
 
@@ -46,11 +50,21 @@ struct abcg::VulkanPipelineCreateInfo {
  *
  * This class provides helper functions for creating and managing vk::Pipeline
  * objects.
+ *
+ * Several pipelines can be created together, optionally on a background
+ * thread. See abcg::VulkanPipeline::createMany and
+ * abcg::VulkanPipeline::createManyAsync.
  */
 class abcg::VulkanPipeline {
 public:
   void create(VulkanSwapchain const &swapchain,
               VulkanPipelineCreateInfo const &createInfo);
+  [[nodiscard]] static std::vector<VulkanPipeline>
+  createMany(VulkanSwapchain const &swapchain,
+             std::vector<VulkanPipelineCreateInfo> const &createInfos);
+  [[nodiscard]] static std::future<std::vector<VulkanPipeline>>
+  createManyAsync(VulkanSwapchain const &swapchain,
+                  std::vector<VulkanPipelineCreateInfo> createInfos);
   void destroy();
 
   explicit operator vk::Pipeline const &() const noexcept;
@@ -58,6 +72,10 @@ public:
   [[nodiscard]] vk::PipelineLayout const &getLayout() const noexcept;
 
 private:
+  [[nodiscard]] static std::vector<VulkanPipeline>
+  createPipelines(VulkanSwapchain const &swapchain,
+                  std::span<VulkanPipelineCreateInfo const> createInfos);
+
   vk::Pipeline m_pipeline;
   vk::PipelineLayout m_pipelineLayout;
   vk::Device m_device;
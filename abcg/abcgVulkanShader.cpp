@@ -9,17 +9,44 @@
  */
 
 #include "abcgVulkanShader.hpp"
+#include "abcgApplication.hpp"
 #include "abcgException.hpp"
+#include "abcgShaderSourceCache.hpp"
+#include "abcgUtil.hpp"
 
 #include <glslang/SPIRV/GlslangToSpv.h>
 
+#include <cppitertools/itertools.hpp>
 #include <fmt/core.h>
 #include <gsl/gsl>
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
 
 namespace {
+// Directory of the SPIR-V cache. The cache is disabled if empty.
+std::string spirvCacheDirectory; // NOLINT(*-avoid-non-const-global-variables)
+
+// Header of the files of the SPIR-V cache
+struct SpirvCacheHeader {
+  std::array<char, 8> magic{'A', 'B', 'C', 'G', 'S', 'P', 'R', 'V'};
+  std::uint32_t version{1};
+  std::uint32_t reserved{};
+  std::uint64_t key{};
+  // Number of 32-bit words of the code
+  std::uint64_t length{};
+  // Hash of the code, to detect corrupted files
+  std::uint64_t checksum{};
+};
+
 TBuiltInResource InitResources() {
   TBuiltInResource Resources{
       .maxLights = 32,
@@ -234,28 +261,106 @@ abcgStageToVulkanStage(abcg::ShaderStage stage) {
   }
 }
 
-// If filenameOrText is a filename, returns the contents of the file (assumed
-// to be in text format). Otherwise, returns filenameOrText.
-[[nodiscard]] std::string toSource(std::string_view filenameOrText) {
-  static const std::size_t maxPathSize{260};
-  if (filenameOrText.size() > maxPathSize ||
-      !std::filesystem::exists(filenameOrText)) {
-    return filenameOrText.data();
+// Hash of the shader source and of the compiler that compiles it
+[[nodiscard]] std::uint64_t spirvCacheKey(std::string_view source,
+                                          abcg::ShaderStage stage) {
+  auto const version{glslang::GetVersion()};
+  return abcg::hashCombine(
+      source, stage, version.major, version.minor, version.patch,
+      std::string_view{version.flavor == nullptr ? "" : version.flavor},
+      glslang::GetSpirvGeneratorVersion());
+}
+
+[[nodiscard]] std::uint64_t spirvChecksum(std::vector<uint32_t> const &code) {
+  return std::hash<std::string_view>{}(
+      std::string_view{reinterpret_cast<char const *>(code.data()),
+                       code.size() * sizeof(uint32_t)});
+}
+
+[[nodiscard]] std::filesystem::path spirvCachePath(std::uint64_t const key) {
+  return std::filesystem::path{spirvCacheDirectory} /
+         fmt::format("{:016x}.spv", key);
+}
+
+// Reads the cached code of a shader. Returns an empty vector if there is no
+// valid code for the key.
+[[nodiscard]] std::vector<uint32_t> loadSpirv(std::uint64_t const key) {
+  auto const path{spirvCachePath(key)};
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream)
+    return {};
+
+  SpirvCacheHeader header;
+  SpirvCacheHeader const expected{.key = key};
+  stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+  std::error_code errorCode;
+  auto const fileSize{std::filesystem::file_size(path, errorCode)};
+  if (!stream || errorCode || header.magic != expected.magic ||
+      header.version != expected.version || header.key != key ||
+      header.length == 0 ||
+      header.length * sizeof(uint32_t) != fileSize - sizeof(header)) {
+    return {};
   }
-  std::stringstream source;
-  if (std::ifstream stream(filenameOrText.data()); stream) {
-    source << stream.rdbuf();
+
+  std::vector<uint32_t> code(gsl::narrow<std::size_t>(header.length));
+  stream.read(reinterpret_cast<char *>(code.data()),
+              gsl::narrow<std::streamsize>(code.size() * sizeof(uint32_t)));
+  if (!stream || spirvChecksum(code) != header.checksum) {
+    // The file is corrupted
     stream.close();
-  } else {
-    throw abcg::RuntimeError(
-        fmt::format("Failed to read file {}", filenameOrText));
+    std::filesystem::remove(path, errorCode);
+    return {};
   }
-  return source.str();
+  return code;
+}
+
+// Writes the code of a shader to the cache. Errors are ignored, as the shader
+// is then compiled again in the next run.
+void saveSpirv(std::uint64_t const key, std::vector<uint32_t> const &code) {
+  std::error_code errorCode;
+  std::filesystem::create_directories(spirvCacheDirectory, errorCode);
+  if (errorCode)
+    return;
+
+  SpirvCacheHeader const header{.key = key, .length = code.size(),
+                                .checksum = spirvChecksum(code)};
+
+  // Write to a temporary file first so that a partially written file is never
+  // read. The name of the file is unique to the thread, as the same shader
+  // may be compiled by several threads.
+  auto const path{spirvCachePath(key)};
+  auto const tempPath{std::filesystem::path{spirvCacheDirectory} /
+                      fmt::format("{:016x}.{:x}.tmp", key,
+                                  std::hash<std::thread::id>{}(
+                                      std::this_thread::get_id()))};
+  {
+    std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    stream.write(reinterpret_cast<char const *>(code.data()),
+                 gsl::narrow<std::streamsize>(code.size() * sizeof(uint32_t)));
+    if (!stream) {
+      stream.close();
+      std::filesystem::remove(tempPath, errorCode);
+      return;
+    }
+  }
+  std::filesystem::rename(tempPath, path, errorCode);
+  if (errorCode) {
+    std::filesystem::remove(tempPath, errorCode);
+  }
+}
+
+// If filenameOrText is a filename, returns the contents of the file (assumed
+// to be in text format) with its includes resolved. Otherwise, returns
+// filenameOrText.
+[[nodiscard]] std::shared_ptr<std::string const>
+toSource(std::string_view filenameOrText) {
+  return abcg::ShaderSourceCache::getInstance().load(filenameOrText);
 }
-} // namespace
 
 // Compiles the given GLSL shader source into Vulkan SPIR-V.
-std::vector<uint32_t> GLSLtoSPV(abcg::ShaderSource shaderSource) {
+std::vector<uint32_t> GLSLtoSPV(std::string_view source,
+                                abcg::ShaderStage shaderStage) {
   // Prints out log info for compiling and linking
   auto printLog{[](glslang::TShader &shader, std::string_view name) {
     if (std::string const log{shader.getInfoLog()}; !log.empty()) {
@@ -266,10 +371,11 @@ std::vector<uint32_t> GLSLtoSPV(abcg::ShaderSource shaderSource) {
     }
   }};
 
-  auto const *data{shaderSource.source.data()};
-  auto const stage{abcgStageToGlslangStage(shaderSource.stage)};
+  auto const *data{source.data()};
+  auto const length{gsl::narrow<int>(source.size())};
+  auto const stage{abcgStageToGlslangStage(shaderStage)};
   glslang::TShader shader(stage);
-  shader.setStrings(&data, 1);
+  shader.setStringsWithLengths(&data, &length, 1);
 
   // Enable SPIR-V and Vulkan rules when parsing GLSL
   auto messages{gsl::narrow<EShMessages>(EShMsgSpvRules |
@@ -301,9 +407,49 @@ std::vector<uint32_t> GLSLtoSPV(abcg::ShaderSource shaderSource) {
   return outCode;
 }
 
+// Initializes glslang on the first call. glslang is finalized when the process
+// exits, so that shaders can be compiled concurrently without initializing
+// and finalizing it around each compilation.
+void initializeGlslang() {
+  static auto const initialized{[] {
+    auto const result{glslang::InitializeProcess()};
+    std::atexit([] { glslang::FinalizeProcess(); });
+    return result;
+  }()};
+  if (!initialized) {
+    throw abcg::RuntimeError("Failed to initialize glslang");
+  }
+}
+
+// Compiles a shader to SPIR-V, or reads its code from the SPIR-V cache
+[[nodiscard]] std::vector<uint32_t>
+compileShader(abcg::ShaderSource const &pathOrSource) {
+  // Keeps the source shared with the source cache alive while compiling
+  auto const source{toSource(pathOrSource.source)};
+
+  auto const useCache{!spirvCacheDirectory.empty()};
+  auto const cacheKey{useCache ? spirvCacheKey(*source, pathOrSource.stage)
+                               : 0};
+  if (useCache) {
+    if (auto code{loadSpirv(cacheKey)}; !code.empty())
+      return code;
+  }
+
+  initializeGlslang();
+  auto code{GLSLtoSPV(*source, pathOrSource.stage)};
+  if (useCache) {
+    saveSpirv(cacheKey, code);
+  }
+  return code;
+}
+} // namespace
+
 /**
  * @brief Compiles a GLSL shader to SPIR-V and creates its module.
  *
+ * If the SPIR-V cache is enabled (see abcg::setVulkanShaderCacheDirectory),
+ * the code is read from the cache when the same source was compiled before.
+ *
  * @param device Vulkan device to be used to create the shader module.
  * @param pathOrSource Path or source code of the GLSL shader to be compiled to
  * SPIR-V.
@@ -313,18 +459,59 @@ std::vector<uint32_t> GLSLtoSPV(abcg::ShaderSource shaderSource) {
  */
 void abcg::VulkanShader::create(VulkanDevice const &device,
                                 ShaderSource const &pathOrSource) {
-  m_device = static_cast<vk::Device>(device);
-
-  ShaderSource const source{.source = toSource(pathOrSource.source),
-                            .stage = pathOrSource.stage};
+  createModule(device, pathOrSource, compileShader(pathOrSource));
+}
 
-  glslang::InitializeProcess();
-  std::vector<uint32_t> shader{GLSLtoSPV(source)};
-  m_stage = abcgStageToVulkanStage(source.stage);
-  glslang::FinalizeProcess();
+/**
+ * @brief Compiles GLSL shaders to SPIR-V concurrently and creates their
+ * modules.
+ *
+ * The shaders are compiled by the job system of the application (see
+ * abcg::Application::getJobSystem), one job per shader, while the calling
+ * thread also compiles shaders. If the job system is not running, the shaders
+ * are compiled on the calling thread. The modules are created on the calling
+ * thread after all shaders are compiled.
+ *
+ * This is faster than calling abcg::VulkanShader::create for each shader of
+ * the pipelines of an application.
+ *
+ * @param device Vulkan device to be used to create the shader modules.
+ * @param pathsOrSources Paths or source codes of the GLSL shaders to be
+ * compiled to SPIR-V.
+ *
+ * @throw abcg::RuntimeError if a shader could not be read from file or has
+ * failed to compile. No module is created in this case.
+ *
+ * @return Shaders in the same order as @a pathsOrSources.
+ */
+std::vector<abcg::VulkanShader> abcg::VulkanShader::createMany(
+    VulkanDevice const &device,
+    std::vector<ShaderSource> const &pathsOrSources) {
+  std::vector<std::vector<uint32_t>> codes(pathsOrSources.size());
+  auto const compileRange{[&](std::size_t begin, std::size_t end) {
+    for (auto const index : iter::range(begin, end)) {
+      codes.at(index) = compileShader(pathsOrSources.at(index));
+    }
+  }};
+  if (auto *jobSystem{Application::getJobSystem()}; jobSystem != nullptr) {
+    jobSystem->parallelFor(pathsOrSources.size(), 1, compileRange);
+  } else {
+    compileRange(0, pathsOrSources.size());
+  }
 
-  m_module = m_device.createShaderModule(
-      {.codeSize = shader.size() * sizeof(uint32_t), .pCode = shader.data()});
+  std::vector<VulkanShader> shaders(pathsOrSources.size());
+  try {
+    for (auto const index : iter::range(pathsOrSources.size())) {
+      shaders.at(index).createModule(device, pathsOrSources.at(index),
+                                     codes.at(index));
+    }
+  } catch (...) {
+    for (auto &shader : shaders) {
+      shader.destroy();
+    }
+    throw;
+  }
+  return shaders;
 }
 
 /**
@@ -335,9 +522,116 @@ void abcg::VulkanShader::destroy() {
     return;
   }
 
+  m_hotReload.reset();
   m_device.destroyShaderModule(m_module);
 }
 
+void abcg::VulkanShader::createModule(VulkanDevice const &device,
+                                      ShaderSource const &pathOrSource,
+                                      std::vector<uint32_t> const &code) {
+  m_device = static_cast<vk::Device>(device);
+  m_pathOrSource = pathOrSource;
+  m_stage = abcgStageToVulkanStage(pathOrSource.stage);
+
+  m_module = m_device.createShaderModule(
+      {.codeSize = code.size() * sizeof(uint32_t), .pCode = code.data()});
+}
+
+/**
+ * @brief Starts watching the shader file and the files it includes.
+ *
+ * When the file changes, abcg::VulkanShader::updateHotReload recompiles the
+ * shader on a background thread and recreates the module only if the
+ * compilation succeeds.
+ *
+ * This function has no effect if the shader was created from source code
+ * instead of a path.
+ */
+void abcg::VulkanShader::enableHotReload() {
+  m_hotReload = std::make_shared<HotReload>();
+  if (!m_hotReload->watcher.watch(m_pathOrSource.source)) {
+    m_hotReload.reset();
+    return;
+  }
+  for (auto const &dependency :
+       ShaderSourceCache::getInstance().getDependencies(
+           m_pathOrSource.source)) {
+    m_hotReload->watcher.watch(dependency);
+  }
+}
+
+/**
+ * @brief Advances the recompilation of the shader from its file.
+ *
+ * This function must be called regularly (e.g., at the beginning of
+ * abcg::VulkanWindow::onPaint) after abcg::VulkanShader::enableHotReload.
+ * It does not wait for the compilation, which runs on a background thread.
+ *
+ * If the compilation succeeds, the previous module is destroyed and the new
+ * one takes its place. This is the hook for recreating the pipelines that use
+ * the shader, which still refer to the previous module: the caller must
+ * recreate them (e.g., with abcg::VulkanPipeline::destroy followed by
+ * abcg::VulkanPipeline::create) when this function returns `true`. If the
+ * compilation fails, the information log is printed and the previous module
+ * is kept.
+ *
+ * @remark This function must be called on the render thread, as the module
+ * must not be replaced while commands are recorded or pipelines are created
+ * with it. Do not call it in abcg::VulkanWindow::onUpdate, which may run on a
+ * worker thread if abcg::WindowSettings::pipelinedUpdate is enabled.
+ * @remark Copies of this object share the watcher but not the module. Only
+ * the object that is updated has its module replaced.
+ *
+ * @return `true` if the module was replaced; `false` otherwise.
+ */
+bool abcg::VulkanShader::updateHotReload() {
+  if (!m_hotReload)
+    return false;
+  auto &hotReload{*m_hotReload};
+
+  for (auto const &file : hotReload.watcher.poll()) {
+    ShaderSourceCache::getInstance().invalidate(file);
+    hotReload.changed = true;
+  }
+
+  auto replaced{false};
+  if (hotReload.code.valid()) {
+    if (hotReload.code.wait_for(std::chrono::seconds{0}) !=
+        std::future_status::ready)
+      return false;
+    try {
+      auto const code{hotReload.code.get()};
+      // Discard the result if the file changed again while compiling
+      if (!hotReload.changed) {
+        auto const newModule{m_device.createShaderModule(
+            {.codeSize = code.size() * sizeof(uint32_t),
+             .pCode = code.data()})};
+        m_device.destroyShaderModule(m_module);
+        m_module = newModule;
+        replaced = true;
+        // Watch the files that are now included
+        for (auto const &dependency :
+             ShaderSourceCache::getInstance().getDependencies(
+                 m_pathOrSource.source)) {
+          hotReload.watcher.watch(dependency);
+        }
+      }
+    } catch (abcg::RuntimeError const &exception) {
+      fmt::print("Failed to reload shader: {}\n", exception.what());
+    }
+  }
+
+  if (hotReload.changed) {
+    hotReload.changed = false;
+    hotReload.code =
+        std::async(std::launch::async, [pathOrSource = m_pathOrSource] {
+          return compileShader(pathOrSource);
+        });
+  }
+
+  return replaced;
+}
+
 /**
  * @brief Returns the shader stage bitmask.
  *
@@ -354,4 +648,44 @@ vk::ShaderStageFlagBits const &abcg::VulkanShader::getStage() const noexcept {
  */
 vk::ShaderModule const &abcg::VulkanShader::getModule() const noexcept {
   return m_module;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Compiles a GLSL shader to SPIR-V.
+ *
+ * This is the compilation done by abcg::VulkanShader::create, without creating
+ * the shader module. glslang is initialized on the first call. If the SPIR-V
+ * cache is enabled (see abcg::setVulkanShaderCacheDirectory), the code is read
+ * from the cache when the same source was compiled before.
+ *
+ * @param pathOrSource Path or source code of the GLSL shader.
+ *
+ * @throw abcg::RuntimeError if the shader could not be read from file or has
+ * failed to compile.
+ *
+ * @return SPIR-V code.
+ */
+std::vector<uint32_t>
+abcg::compileVulkanShader(ShaderSource const &pathOrSource) {
+  return compileShader(pathOrSource);
+}
+
+/**
+ * @brief Sets the directory of the SPIR-V cache used by
+ * abcg::VulkanShader::create.
+ *
+ * abcg::VulkanWindow sets it to the `cache` subdirectory of
+ * abcg::Application::getBasePath if abcg::VulkanSettings::spirvCache is
+ * `true`. The directory is created when the first shader is saved.
+ *
+ * Cached files are looked up by a hash of the shader source and stage and of
+ * the glslang version. Files are written to a temporary file that is then
+ * renamed, and are validated by a header with the key, the length and a
+ * checksum of the code before being used.
+ *
+ * @param directory Path to the cache directory. An empty path disables the
+ * cache.
+ */
+void abcg::setVulkanShaderCacheDirectory(std::string_view directory) {
+  spirvCacheDirectory = directory;
+}
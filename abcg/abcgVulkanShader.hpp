@@ -11,6 +11,13 @@
 #ifndef ABCG_VULKAN_SHADER_HPP_
 #define ABCG_VULKAN_SHADER_HPP_
 
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "abcgFileWatcher.hpp"
 #include "abcgShader.hpp"
 #include "abcgVulkanDevice.hpp"
 
@@ -23,19 +30,49 @@ class VulkanShader;
  *
  * This class compiles a GLSL shader into a Vulkan SPIR-V shader and creates the
  * corresponding vk::ShaderModule.
+ *
+ * The module can be recreated when the shader file changes. See
+ * abcg::VulkanShader::enableHotReload.
  */
 class abcg::VulkanShader {
 public:
   void create(VulkanDevice const &device, ShaderSource const &pathOrSource);
+  [[nodiscard]] static std::vector<VulkanShader>
+  createMany(VulkanDevice const &device,
+             std::vector<ShaderSource> const &pathsOrSources);
   void destroy();
 
+  void enableHotReload();
+  bool updateHotReload();
+
   [[nodiscard]] vk::ShaderStageFlagBits const &getStage() const noexcept;
   [[nodiscard]] vk::ShaderModule const &getModule() const noexcept;
 
 private:
+  // State of the recompilation of the shader from its file
+  struct HotReload {
+    FileWatcher watcher;
+    // Compilation in progress, if valid
+    std::future<std::vector<uint32_t>> code;
+    // Whether the file changed since the compilation in progress started
+    bool changed{};
+  };
+
+  void createModule(VulkanDevice const &device,
+                    ShaderSource const &pathOrSource,
+                    std::vector<uint32_t> const &code);
+
+  ShaderSource m_pathOrSource;
+  std::shared_ptr<HotReload> m_hotReload;
   vk::ShaderStageFlagBits m_stage{};
   vk::ShaderModule m_module;
   vk::Device m_device;
 };
 
+namespace abcg {
+[[nodiscard]] std::vector<uint32_t>
+compileVulkanShader(ShaderSource const &pathOrSource);
+void setVulkanShaderCacheDirectory(std::string_view directory);
+} // namespace abcg
+
 #endif
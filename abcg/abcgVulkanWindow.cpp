@@ -16,10 +16,13 @@
 #include <imgui_impl_sdl2.h>
 #include <imgui_impl_vulkan.h>
 
+#include "abcgApplication.hpp"
 #include "abcgEmbeddedFonts.hpp"
 #include "abcgException.hpp"
+#include "abcgProfiler.hpp"
 #include "abcgVulkanError.hpp"
 #include "abcgVulkanInstance.hpp"
+#include "abcgVulkanShader.hpp"
 #include "abcgWindow.hpp"
 
 namespace {
@@ -154,36 +157,37 @@ void abcg::VulkanWindow::onPaint([[maybe_unused]] VulkanFrame const &frame) {}
  *
  * This is not called when the window is minimized.
  *
- * Override it for custom behavior. By default, it shows a FPS counter if
- * abcg::WindowSettings::showFPS is set to `true`, and a toggle fullscreen
- * button if abcg::WindowSettings::showFullscreenButton is set to `true`.
+ * Override it for custom behavior. By default, it shows the frame time
+ * statistics of abcg::FrameStats and a flame graph of the zones recorded by
+ * abcg::Profiler if abcg::WindowSettings::showFPS is set to `true`, and a
+ * toggle fullscreen button if abcg::WindowSettings::showFullscreenButton is
+ * set to `true`.
  */
 void abcg::VulkanWindow::onPaintUI() {
-  // FPS counter
+  // Frame time statistics and flame graph of the profiled zones
   if (abcg::Window::getWindowSettings().showFPS) {
-    auto fps{ImGui::GetIO().Framerate};
+    auto const &frameStats{abcg::Window::getFrameStats()};
 
-    static auto offset{0UL};
+    // Refresh the displayed statistics and frame a few times per second so
+    // that they can be read
     static auto refreshTime{ImGui::GetTime()};
-    static std::array<float, 150> frames{};
-
-    while (refreshTime < ImGui::GetTime()) {
-      auto const refreshFrequency{60.0};
-      frames.at(offset) = fps;
-      offset = (offset + 1) % frames.size();
-      refreshTime += (1.0 / refreshFrequency);
+    static FrameStatsSummary stats;
+    static ProfilerFrame frame;
+    if (refreshTime < ImGui::GetTime()) {
+      auto const refreshFrequency{4.0};
+      stats = frameStats.getSummary();
+      frame = Profiler::getInstance().getFrame();
+      refreshTime = ImGui::GetTime() + 1.0 / refreshFrequency;
     }
 
     ImGui::SetNextWindowPos(ImVec2(5, 5));
     ImGui::Begin("FPS", nullptr,
                  ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs |
                      ImGuiWindowFlags_NoBringToFrontOnFocus |
-                     ImGuiWindowFlags_NoFocusOnAppearing);
-    auto const label{fmt::format("avg {:.1f} FPS", fps)};
-    ImGui::PlotLines("", frames.data(), gsl::narrow<int>(frames.size()),
-                     gsl::narrow<int>(offset), label.c_str(), 0.0f,
-                     *std::ranges::max_element(frames) * 2,
-                     ImVec2(gsl::narrow<float>(frames.size()), 50));
+                     ImGuiWindowFlags_NoFocusOnAppearing |
+                     ImGuiWindowFlags_AlwaysAutoResize);
+    frameStats.show(stats, 300.0f);
+    Profiler::showFlameGraph(frame, 300.0f);
     ImGui::End();
   }
 
@@ -226,10 +230,32 @@ void abcg::VulkanWindow::onResize() {}
  * This virtual function is called just before abcg::VulkanWindow::onPaint, even
  * if the window is minimized.
  *
+ * If abcg::WindowSettings::pipelinedUpdate is enabled, this is called on a
+ * worker thread while the previous frame is painted. In this case, do not
+ * call graphics API or Dear ImGui functions here, and pass the results to
+ * abcg::VulkanWindow::onPaint through an abcg::FrameState.
+ *
  * Override it for custom behavior. By default, it does nothing.
  */
 void abcg::VulkanWindow::onUpdate() {}
 
+/**
+ * @brief Custom handler called at a fixed rate.
+ *
+ * This virtual function is called zero or more times per frame, before
+ * abcg::VulkanWindow::onUpdate, with a constant time step given by
+ * abcg::WindowSettings::fixedDeltaTime. Use it for simulation and game logic
+ * that must not depend on the frame rate. Use
+ * abcg::Window::getInterpolationAlpha in abcg::VulkanWindow::onPaint to
+ * interpolate between the last two simulation states.
+ *
+ * Override it for custom behavior. By default, it does nothing.
+ *
+ * @param deltaTime Time step, in seconds.
+ */
+void abcg::VulkanWindow::onFixedUpdate(
+    [[maybe_unused]] double deltaTime) {}
+
 /**
  * @brief Custom handler for cleaning up Vulkan resources.
  *
@@ -267,6 +293,10 @@ void abcg::VulkanWindow::handleEvent(SDL_Event const &event) {
 }
 
 void abcg::VulkanWindow::create() {
+  if (isHeadless()) {
+    throw abcg::RuntimeError("Headless mode is only supported with OpenGL");
+  }
+
   // Create window fol Vulkan graphics
   if (!createSDLWindow(SDL_WINDOW_VULKAN)) {
     throw abcg::SDLError("SDL_CreateWindow failed");
@@ -302,7 +332,10 @@ void abcg::VulkanWindow::create() {
                           sampleCount);
 
   // Create logical device
-  m_device.create(m_physicalDevice, m_deviceExtensions);
+  m_device.create(m_physicalDevice, m_deviceExtensions,
+                  m_vulkanSettings.pipelineCache
+                      ? Application::getBasePath() + "/cache/pipeline.bin"
+                      : std::string{});
 
   // Create swapchain
   m_swapchain.create(m_device, m_vulkanSettings, getWindowSize());
@@ -352,7 +385,7 @@ void abcg::VulkanWindow::create() {
       .Device = static_cast<vk::Device>(m_device),
       .QueueFamily = m_physicalDevice.getQueuesFamilies().graphics.value_or(0),
       .Queue = m_device.getQueues().graphics,
-      .PipelineCache = VK_NULL_HANDLE,
+      .PipelineCache = m_device.getPipelineCache(),
       .DescriptorPool = m_UIdescriptorPool,
       .Subpass = 0,
       .MinImageCount = 2,
@@ -393,14 +426,24 @@ void abcg::VulkanWindow::create() {
     ImGui_ImplVulkan_DestroyFontUploadObjects();
   }
 
+  if (m_vulkanSettings.spirvCache) {
+    setVulkanShaderCacheDirectory(Application::getBasePath() + "/cache");
+  } else {
+    setVulkanShaderCacheDirectory({});
+  }
+
   onCreate();
 
   onResize();
 }
 
-void abcg::VulkanWindow::paint() {
-  onUpdate();
+void abcg::VulkanWindow::fixedUpdate(double deltaTime) {
+  onFixedUpdate(deltaTime);
+}
+
+void abcg::VulkanWindow::update() { onUpdate(); }
 
+void abcg::VulkanWindow::paint() {
   if (m_hidden || m_minimized)
     return;
 
@@ -415,11 +458,22 @@ void abcg::VulkanWindow::paint() {
   ImGui_ImplSDL2_NewFrame();
   ImGui::NewFrame();
 
-  onPaintUI();
+  {
+    ABCG_PROFILE_ZONE("onPaintUI");
+    onPaintUI();
+  }
+
+  {
+    ABCG_PROFILE_ZONE("ImGui::Render");
+    ImGui::Render();
+  }
 
-  ImGui::Render();
+  m_swapchain.render([this](auto const &frame) {
+    ABCG_PROFILE_ZONE("onPaint");
+    onPaint(frame);
+  });
 
-  m_swapchain.render([this](auto const &frame) { onPaint(frame); });
+  ABCG_PROFILE_ZONE("Present");
   m_swapchain.present();
 }
 
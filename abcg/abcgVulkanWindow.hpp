@@ -57,6 +57,21 @@ struct abcg::VulkanSettings {
    * comes first.
    */
   bool vSync{false};
+
+  /** @brief Whether abcg::VulkanShader::create caches SPIR-V code on disk, in
+   * the `cache` subdirectory of abcg::Application::getBasePath.
+   *
+   * @sa abcg::setVulkanShaderCacheDirectory.
+   */
+  bool spirvCache{false};
+
+  /** @brief Whether the pipeline cache of the device is saved on disk when the
+   * window is destroyed and loaded in the next run, in the `cache`
+   * subdirectory of abcg::Application::getBasePath.
+   *
+   * @sa abcg::VulkanDevice::create.
+   */
+  bool pipelineCache{false};
 };
 
 /**
@@ -72,6 +87,8 @@ struct abcg::VulkanSettings {
  * @sa abcg::VulkanWindow::onPaintUI for UI rendering.
  * @sa abcg::VulkanWindow::onResize for handling swapchain rebuild events.
  * @sa abcg::VulkanWindow::onUpdate for commands to be called every frame.
+ * @sa abcg::VulkanWindow::onFixedUpdate for commands to be called at a fixed
+ * rate.
  * @sa abcg::VulkanWindow::onDestroy for cleaning up Vulkan resources.
  *
  * @remark Objects of this type cannot be copied or copy-constructed.
@@ -92,12 +109,15 @@ protected:
   virtual void onPaintUI();
   virtual void onResize();
   virtual void onUpdate();
+  virtual void onFixedUpdate(double deltaTime);
   virtual void onDestroy();
 
 private:
   void handleEvent(SDL_Event const &event) final;
   void create() final;
   void paint() final;
+  void fixedUpdate(double deltaTime) final;
+  void update() final;
   void destroy() final;
   [[nodiscard]] glm::ivec2 getWindowSize() const final;
 
@@ -12,8 +12,14 @@
 
 #include <SDL_video.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
 #include <imgui_impl_sdl2.h>
 
+#include "abcgProfiler.hpp"
+
 namespace {
 ImVec4 ColorAlpha(ImVec4 const &color, float const alpha) {
   return {color.x, color.y, color.z, alpha};
@@ -158,14 +164,32 @@ abcg::fullscreenchangeCallback(int eventType,
 /**
  * @brief Returns the time that have passed since the last frame.
  *
- * This delta time has a minimum resolution of 2ms. If the time is smaller than
- * that, zero is returned. Internally, the delta time accumulates for the next
- * frame(s) until at least 2ms have passed.
+ * The frame rate is limited by abcg::WindowSettings::targetFPS, so this is
+ * usually not smaller than the target frame period.
  *
  * @returns Time in seconds.
  */
 double abcg::Window::getDeltaTime() const noexcept { return m_lastDeltaTime; }
 
+/**
+ * @brief Returns how far the current frame is between the last two fixed-rate
+ * updates.
+ *
+ * Use this value to interpolate between the previous and current simulation
+ * states when rendering, so that motion looks smooth even when the frame rate
+ * differs from the fixed update rate.
+ *
+ * If abcg::WindowSettings::pipelinedUpdate is enabled, this is the factor of
+ * the update whose state is being painted, not of the update running
+ * concurrently.
+ *
+ * @returns Interpolation factor in the range [0, 1), or 0 if the fixed-rate
+ * update is disabled.
+ */
+double abcg::Window::getInterpolationAlpha() const noexcept {
+  return m_interpolationAlpha;
+}
+
 /**
  * @brief Returns the time that have passed since the window was created.
  *
@@ -173,6 +197,15 @@ double abcg::Window::getDeltaTime() const noexcept { return m_lastDeltaTime; }
  */
 double abcg::Window::getElapsedTime() const { return m_elapsedTime.elapsed(); }
 
+/**
+ * @brief Returns the statistics of the raw frame times of the window.
+ *
+ * @returns Reference to the abcg::FrameStats object updated on each frame.
+ */
+abcg::FrameStats const &abcg::Window::getFrameStats() const noexcept {
+  return m_frameStats;
+}
+
 /**
  * @brief Returns the current configuration settings of the window.
  *
@@ -229,6 +262,14 @@ SDL_Window *abcg::Window::getSDLWindow() const noexcept { return m_window; }
  */
 Uint32 abcg::Window::getSDLWindowID() const noexcept { return m_windowID; }
 
+/**
+ * @brief Returns whether the window renders to an offscreen surface.
+ *
+ * @returns `true` if abcg::WindowSettings::headless was set when the window
+ * was created; `false` otherwise.
+ */
+bool abcg::Window::isHeadless() const noexcept { return m_headless; }
+
 /**
  * @brief Creates the SDL window.
  *
@@ -314,6 +355,20 @@ void abcg::Window::toggleFullscreen() {
 #endif
 }
 
+/**
+ * @brief Registers a double-buffered state to be swapped between frames.
+ *
+ * The state is swapped after the update stage and before the render stage
+ * of each frame. The object must outlive the window or the application loop.
+ *
+ * @param frameState State exchanged between the update and render stages.
+ *
+ * @sa abcg::WindowSettings::pipelinedUpdate.
+ */
+void abcg::Window::registerFrameState(FrameStateBase &frameState) {
+  m_frameStates.push_back(&frameState);
+}
+
 void abcg::Window::templateHandleEvent(SDL_Event const &event, bool &done) {
   ImGui_ImplSDL2_ProcessEvent(&event);
 
@@ -381,33 +436,119 @@ void abcg::Window::templateHandleEvent(SDL_Event const &event, bool &done) {
 }
 
 void abcg::Window::templateCreate() {
-  m_deltaTime.restart();
+  m_headless = m_windowSettings.headless;
+
   m_elapsedTime.restart();
+  m_frameStats.reset();
 
   create();
 
+#if !defined(__EMSCRIPTEN__)
+  if (m_windowSettings.pipelinedUpdate) {
+    m_updateWorker = std::make_unique<WorkerThread>();
+  }
+
+  auto traceFile{m_windowSettings.traceFile};
+  if (auto const *envTraceFile{std::getenv("ABCG_TRACE_FILE")};
+      traceFile.empty() && envTraceFile != nullptr) {
+    traceFile = envTraceFile;
+  }
+  if (!traceFile.empty()) {
+    m_traceExporter = std::make_unique<TraceExporter>(traceFile);
+  }
+#endif
+
   // Set up our own Dear ImGui style
   setupImGuiStyle(true, 1.0f);
+
+  // Start measuring the first frame only now, so that the time spent in
+  // create() does not count as a frame
+  m_deltaTime.restart();
 }
 
 void abcg::Window::templatePaint() {
-  // Cap to 480 Hz
-  if (m_deltaTime.elapsed() >= 1.0 / 480.0) {
-    m_lastDeltaTime = m_deltaTime.restart();
+  auto &profiler{Profiler::getInstance()};
+  profiler.beginFrame();
+
+#if !defined(__EMSCRIPTEN__)
+  if (!m_headless) {
+    ABCG_PROFILE_ZONE("Frame pacing");
+    m_framePacer.setTargetFPS(m_windowSettings.targetFPS);
+    m_framePacer.wait();
+  }
+#endif
+  m_lastDeltaTime = m_deltaTime.restart();
+  m_frameStats.addFrame(m_lastDeltaTime);
+
+  if (m_updateWorker) {
+    // Render the state of the last update while the next one is computed
+    for (auto *frameState : m_frameStates) {
+      frameState->swap();
+    }
+    m_interpolationAlpha = m_updateInterpolationAlpha;
+    m_updateWorker->post([this] { simulate(); });
+    paint();
+    m_updateWorker->wait();
   } else {
-    m_lastDeltaTime = 0.0;
+    simulate();
+    for (auto *frameState : m_frameStates) {
+      frameState->swap();
+    }
+    m_interpolationAlpha = m_updateInterpolationAlpha;
+    paint();
   }
 
-  paint();
+  profiler.endFrame();
+
+  if (m_traceExporter) {
+    m_traceExporter->update();
+  }
+}
+
+// Update stage of a frame: fixed-rate updates followed by the per-frame update
+void abcg::Window::simulate() {
+  if (auto const fixedDeltaTime{m_windowSettings.fixedDeltaTime};
+      fixedDeltaTime > 0.0) {
+    ABCG_PROFILE_ZONE("onFixedUpdate");
+    m_fixedUpdateAccumulator += m_lastDeltaTime;
+    auto const maxUpdates{
+        std::max(1, m_windowSettings.maxFixedUpdatesPerFrame)};
+    auto numUpdates{0};
+    while (m_fixedUpdateAccumulator >= fixedDeltaTime) {
+      if (numUpdates == maxUpdates) {
+        // Too far behind. Drop the excess time
+        m_fixedUpdateAccumulator =
+            std::fmod(m_fixedUpdateAccumulator, fixedDeltaTime);
+        break;
+      }
+      fixedUpdate(fixedDeltaTime);
+      m_fixedUpdateAccumulator -= fixedDeltaTime;
+      ++numUpdates;
+    }
+    m_updateInterpolationAlpha = m_fixedUpdateAccumulator / fixedDeltaTime;
+  } else {
+    m_fixedUpdateAccumulator = 0.0;
+    m_updateInterpolationAlpha = 0.0;
+  }
+
+  ABCG_PROFILE_ZONE("onUpdate");
+  update();
 }
 
 void abcg::Window::templateDestroy() {
-  if (m_window == nullptr)
+  if (m_window == nullptr && !m_headless)
     return;
 
+  m_updateWorker.reset();
+
   destroy();
 
-  SDL_DestroyWindow(m_window);
-  m_window = nullptr;
-  m_windowID = 0;
+  m_traceExporter.reset();
+
+  if (m_window != nullptr) {
+    SDL_DestroyWindow(m_window);
+    m_window = nullptr;
+    m_windowID = 0;
+  }
+  m_headless = false;
 }
\ No newline at end of file
@@ -13,10 +13,17 @@
 #ifndef ABCG_WINDOW_HPP_
 #define ABCG_WINDOW_HPP_
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "abcgExternal.hpp"
+#include "abcgFramePacer.hpp"
+#include "abcgFrameStats.hpp"
+#include "abcgFrameState.hpp"
 #include "abcgTimer.hpp"
+#include "abcgTraceExporter.hpp"
+#include "abcgWorkerThread.hpp"
 
 #if defined(__EMSCRIPTEN__)
 #include "abcgOpenGLExternal.hpp"
@@ -68,6 +75,88 @@ struct abcg::WindowSettings {
   std::string fullscreenElementID{"#canvas"};
   /** @brief String containing the window title. */
   std::string title{"ABCg Window"};
+  /** @brief Whether to render to an offscreen surface instead of a SDL
+   * window.
+   *
+   * In headless mode, no SDL window is created and no events are polled. The
+   * offscreen surface has the size given by abcg::WindowSettings::width and
+   * abcg::WindowSettings::height. This must be set before calling
+   * `abcg::Application::run`.
+   *
+   * @remark Only supported by abcg::OpenGLWindow on platforms with EGL. EGL
+   * is detected by CMake with or without Conan. If it is not found, running in
+   * headless mode throws abcg::RuntimeError.
+   */
+  bool headless{false};
+  /** @brief Number of frames to render in headless mode before exiting.
+   *
+   * Zero means no limit on the number of frames. If both this and
+   * abcg::WindowSettings::headlessDuration are zero, a single frame is
+   * rendered.
+   */
+  std::size_t headlessFrames{0};
+  /** @brief Time, in seconds, to keep rendering in headless mode before
+   * exiting.
+   *
+   * Zero means no time limit.
+   */
+  double headlessDuration{0.0};
+  /** @brief Maximum number of frames per second.
+   *
+   * The main loop sleeps between frames to keep the frame rate at or below
+   * this value. Zero disables the limit.
+   *
+   * @remark This has no effect in headless mode and when the application is
+   * built for WebAssembly, as the browser controls the frame rate.
+   */
+  double targetFPS{480.0};
+  /** @brief Time step, in seconds, of the fixed-rate update.
+   *
+   * The fixed-rate update handler (e.g., abcg::OpenGLWindow::onFixedUpdate) is
+   * called as many times as needed to keep up with the elapsed time, each time
+   * advancing the simulation by this amount. Zero disables the fixed-rate
+   * update.
+   */
+  double fixedDeltaTime{1.0 / 60.0};
+  /** @brief Maximum number of fixed-rate updates per frame.
+   *
+   * If the simulation falls behind by more than this number of steps (e.g.,
+   * after a long frame), the remaining time is discarded so that the
+   * application does not spiral into ever longer frames. Values smaller than 1
+   * are treated as 1.
+   */
+  int maxFixedUpdatesPerFrame{8};
+  /** @brief Whether to run the update stage of a frame on a worker thread,
+   * concurrently with the rendering of the previous frame.
+   *
+   * When enabled, the fixed-rate and per-frame update handlers (e.g.,
+   * abcg::OpenGLWindow::onFixedUpdate and abcg::OpenGLWindow::onUpdate) of
+   * frame N+1 run on a worker thread while the main thread renders frame N.
+   * State shared between the two stages must be exchanged through
+   * abcg::FrameState objects registered with abcg::Window::registerFrameState.
+   *
+   * The update handlers must not call graphics API functions or Dear ImGui
+   * functions, and must not touch state that is also used by the event and UI
+   * handlers (e.g., abcg::OpenGLWindow::onEvent and
+   * abcg::OpenGLWindow::onPaintUI), as these run on the main thread
+   * concurrently with the update.
+   *
+   * This must be set before calling `abcg::Application::run`. It is ignored
+   * when the application is built for WebAssembly.
+   */
+  bool pipelinedUpdate{false};
+  /** @brief Path of a JSON file to which the frames recorded by
+   * abcg::Profiler are written in the Trace Event Format.
+   *
+   * If empty, the value of the environment variable `ABCG_TRACE_FILE` is used,
+   * if set. If both are empty, no trace is written.
+   *
+   * This must be set before calling `abcg::Application::run`. It is ignored
+   * when the application is built for WebAssembly.
+   *
+   * @sa abcg::TraceExporter.
+   */
+  std::string traceFile{};
 };
 
 /**
@@ -134,6 +223,25 @@ protected:
    */
   virtual void paint() = 0;
 
+  /**
+   * @brief Custom handler for fixed-rate updates.
+   *
+   * This is called zero or more times per frame before abcg::Window::paint,
+   * with a constant time step given by abcg::WindowSettings::fixedDeltaTime.
+   *
+   * @param deltaTime Time step, in seconds.
+   */
+  virtual void fixedUpdate(double deltaTime) = 0;
+
+  /**
+   * @brief Custom handler for per-frame updates.
+   *
+   * This is called once per frame, after the fixed-rate updates and before
+   * abcg::Window::paint. If abcg::WindowSettings::pipelinedUpdate is enabled,
+   * this is called on a worker thread.
+   */
+  virtual void update() = 0;
+
   /**
    * @brief Custom handler for window cleanup tasks.
    *
@@ -154,18 +262,23 @@ protected:
 
   [[nodiscard]] double getDeltaTime() const noexcept;
   [[nodiscard]] double getElapsedTime() const;
+  [[nodiscard]] FrameStats const &getFrameStats() const noexcept;
+  [[nodiscard]] double getInterpolationAlpha() const noexcept;
   [[nodiscard]] SDL_Window *getSDLWindow() const noexcept;
   [[nodiscard]] Uint32 getSDLWindowID() const noexcept;
+  [[nodiscard]] bool isHeadless() const noexcept;
 
   bool createSDLWindow(SDL_WindowFlags extraFlags);
   void setEnableResizingEventWatcher(bool enabled) noexcept;
   void toggleFullscreen();
+  void registerFrameState(FrameStateBase &frameState);
 
 private:
   void templateHandleEvent(SDL_Event const &event, bool &done);
   void templateCreate();
   void templatePaint();
   void templateDestroy();
+  void simulate();
 
   SDL_Window *m_window{};
   Uint32 m_windowID{};
@@ -175,8 +288,20 @@ private:
   Timer m_deltaTime;
   Timer m_elapsedTime;
   double m_lastDeltaTime{};
+  FramePacer m_framePacer;
+  FrameStats m_frameStats;
+  double m_fixedUpdateAccumulator{};
+  // Interpolation factor of the frame being painted, read by the render thread
+  double m_interpolationAlpha{};
+  // Interpolation factor of the last update, written by the update thread
+  double m_updateInterpolationAlpha{};
+
+  std::vector<FrameStateBase *> m_frameStates;
+  std::unique_ptr<WorkerThread> m_updateWorker;
+  std::unique_ptr<TraceExporter> m_traceExporter;
 
   bool m_enableResizingEventWatcher{true};
+  bool m_headless{};
 
   friend Application;
   friend int resizingEventWatcher(void *data, SDL_Event *event);
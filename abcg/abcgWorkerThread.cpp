@@ -0,0 +1,88 @@
+/**
+ * @file abcgWorkerThread.cpp
+ * @brief Definition of abcg::WorkerThread members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgWorkerThread.hpp"
+
+#include <utility>
+
+/**
+ * @brief Starts the worker thread.
+ */
+abcg::WorkerThread::WorkerThread() : m_thread{&WorkerThread::run, this} {}
+
+/**
+ * @brief Waits for the current task, if any, and joins the worker thread.
+ */
+abcg::WorkerThread::~WorkerThread() {
+  {
+    std::unique_lock lock{m_mutex};
+    m_condition.wait(lock, [this] { return !m_busy; });
+    m_stop = true;
+  }
+  m_condition.notify_all();
+  m_thread.join();
+}
+
+/**
+ * @brief Posts a task to be run on the worker thread.
+ *
+ * If a task is still running, this blocks until it finishes.
+ *
+ * @param task Function to be called on the worker thread.
+ */
+void abcg::WorkerThread::post(std::function<void()> task) {
+  {
+    std::unique_lock lock{m_mutex};
+    m_condition.wait(lock, [this] { return !m_busy; });
+    m_task = std::move(task);
+    m_busy = true;
+  }
+  m_condition.notify_all();
+}
+
+/**
+ * @brief Blocks until the posted task, if any, has finished.
+ *
+ * If the task exited with an exception, the exception is rethrown on the
+ * calling thread.
+ */
+void abcg::WorkerThread::wait() {
+  std::unique_lock lock{m_mutex};
+  m_condition.wait(lock, [this] { return !m_busy; });
+  if (m_exception) {
+    std::rethrow_exception(std::exchange(m_exception, nullptr));
+  }
+}
+
+void abcg::WorkerThread::run() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock lock{m_mutex};
+      m_condition.wait(lock, [this] { return m_busy || m_stop; });
+      if (m_stop)
+        return;
+      task = std::move(m_task);
+    }
+
+    try {
+      task();
+    } catch (...) {
+      std::scoped_lock const lock{m_mutex};
+      m_exception = std::current_exception();
+    }
+
+    {
+      std::scoped_lock const lock{m_mutex};
+      m_busy = false;
+    }
+    m_condition.notify_all();
+  }
+}
@@ -0,0 +1,59 @@
+/**
+ * @file abcgWorkerThread.hpp
+ * @brief Header file of abcg::WorkerThread.
+ *
+ * Declaration of abcg::WorkerThread class.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2023 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_WORKER_THREAD_HPP_
+#define ABCG_WORKER_THREAD_HPP_
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace abcg {
+class WorkerThread;
+} // namespace abcg
+
+/**
+ * @brief Runs tasks one at a time on a dedicated thread.
+ *
+ * A task is posted with abcg::WorkerThread::post and runs asynchronously
+ * until abcg::WorkerThread::wait is called. Only one task can be in flight at
+ * a time.
+ *
+ * @remark Objects of this type cannot be copied or moved.
+ */
+class abcg::WorkerThread {
+public:
+  WorkerThread();
+  WorkerThread(WorkerThread const &) = delete;
+  WorkerThread(WorkerThread &&) = delete;
+  WorkerThread &operator=(WorkerThread const &) = delete;
+  WorkerThread &operator=(WorkerThread &&) = delete;
+  ~WorkerThread();
+
+  void post(std::function<void()> task);
+  void wait();
+
+private:
+  void run();
+
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::function<void()> m_task;
+  std::exception_ptr m_exception;
+  bool m_busy{};
+  bool m_stop{};
+  std::thread m_thread;
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include <fmt/format.h>
+
+namespace {
+// Minimum duration of a single repeat
+constexpr std::chrono::milliseconds minRepeatDuration{20};
+
+[[nodiscard]] double measure(BenchmarkBody const &body,
+                             std::size_t iterations) {
+  auto const start{std::chrono::steady_clock::now()};
+  body(iterations);
+  auto const end{std::chrono::steady_clock::now()};
+  return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+// Doubles the number of iterations until a run lasts at least
+// minRepeatDuration
+[[nodiscard]] std::size_t calibrate(BenchmarkBody const &body) {
+  auto const target{
+      std::chrono::duration<double, std::nano>(minRepeatDuration).count()};
+  std::size_t iterations{1};
+  while (true) {
+    auto const elapsed{measure(body, iterations)};
+    if (elapsed >= target) {
+      return iterations;
+    }
+    // Jump close to the target once the timing is meaningful
+    if (elapsed > target / 100.0) {
+      return std::max(iterations + 1,
+                      static_cast<std::size_t>(
+                          static_cast<double>(iterations) * target / elapsed));
+    }
+    iterations *= 2;
+  }
+}
+
+[[nodiscard]] std::string escapeJSON(std::string_view str) {
+  std::string escaped;
+  for (auto const character : str) {
+    if (character == '"' || character == '\\') {
+      escaped += '\\';
+    }
+    escaped += character;
+  }
+  return escaped;
+}
+} // namespace
+
+void BenchmarkRunner::add(std::string name, BenchmarkBody body) {
+  m_benchmarks.push_back({.name = std::move(name), .body = std::move(body)});
+}
+
+std::vector<BenchmarkResult> BenchmarkRunner::run(std::string_view filter,
+                                                  std::size_t repeats) const {
+  repeats = std::max<std::size_t>(repeats, 1);
+
+  std::vector<BenchmarkResult> results;
+  for (auto const &benchmark : m_benchmarks) {
+    if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) {
+      continue;
+    }
+
+    // Warm up caches and lazy initializations
+    benchmark.body(1);
+
+    auto const iterations{calibrate(benchmark.body)};
+
+    std::vector<double> samples;
+    samples.reserve(repeats);
+    for (std::size_t repeat{}; repeat < repeats; ++repeat) {
+      samples.push_back(measure(benchmark.body, iterations) /
+                        static_cast<double>(iterations));
+    }
+    std::ranges::sort(samples);
+
+    auto const middle{samples.size() / 2};
+    auto const median{samples.size() % 2 == 0
+                          ? (samples[middle - 1] + samples[middle]) / 2.0
+                          : samples[middle]};
+
+    results.push_back({.name = benchmark.name,
+                       .iterations = iterations,
+                       .repeats = repeats,
+                       .median = median,
+                       .min = samples.front(),
+                       .max = samples.back()});
+
+    fmt::print(stderr, "{:<40} {:>14.1f} ns/op (min {:.1f}, max {:.1f})\n",
+               benchmark.name, median, samples.front(), samples.back());
+  }
+  return results;
+}
+
+std::string toJSON(std::vector<BenchmarkResult> const &results) {
+  std::string json{"{\n  \"unit\": \"ns/op\",\n  \"benchmarks\": ["};
+  for (auto const &result : results) {
+    json += fmt::format(
+        "{}\n    {{\"name\": \"{}\", \"iterations\": {}, \"repeats\": {}, "
+        "\"median\": {:.3f}, \"min\": {:.3f}, \"max\": {:.3f}}}",
+        &result == &results.front() ? "" : ",", escapeJSON(result.name),
+        result.iterations, result.repeats, result.median, result.min,
+        result.max);
+  }
+  json += "\n  ]\n}\n";
+  return json;
+}
@@ -0,0 +1,58 @@
+#ifndef BENCHMARK_HPP_
+#define BENCHMARK_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Result of a benchmark, in nanoseconds per iteration
+struct BenchmarkResult {
+  std::string name{};
+  std::size_t iterations{};
+  std::size_t repeats{};
+  double median{};
+  double min{};
+  double max{};
+};
+
+// A benchmark body runs the measured operation the given number of times
+using BenchmarkBody = std::function<void(std::size_t iterations)>;
+
+class BenchmarkRunner {
+public:
+  void add(std::string name, BenchmarkBody body);
+  std::vector<BenchmarkResult> run(std::string_view filter,
+                                   std::size_t repeats) const;
+
+private:
+  struct Benchmark {
+    std::string name{};
+    BenchmarkBody body{};
+  };
+
+  std::vector<Benchmark> m_benchmarks;
+};
+
+// Prevents the compiler from optimizing away the computation of value
+template <typename T> void doNotOptimize(T const &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile char const *sink{};
+  sink = reinterpret_cast<char const volatile *>(&value);
+#endif
+}
+
+std::string toJSON(std::vector<BenchmarkResult> const &results);
+
+void registerImageBenchmarks(BenchmarkRunner &runner);
+void registerHashBenchmarks(BenchmarkRunner &runner);
+void registerModelBenchmarks(BenchmarkRunner &runner);
+void registerTrackBallBenchmarks(BenchmarkRunner &runner);
+#if defined(ABCG_BENCH_VULKAN)
+void registerShaderBenchmarks(BenchmarkRunner &runner);
+#endif
+
+#endif
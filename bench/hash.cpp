@@ -0,0 +1,31 @@
+#include "benchmark.hpp"
+
+#include <string>
+
+#include "abcgExternal.hpp"
+#include "abcgUtil.hpp"
+
+void registerHashBenchmarks(BenchmarkRunner &runner) {
+  runner.add("hashCombine/size_t x3", [](std::size_t iterations) {
+    for (std::size_t i{}; i < iterations; ++i) {
+      doNotOptimize(abcg::hashCombine(i, i + 1, i + 2));
+    }
+  });
+
+  runner.add("hashCombine/vec3+vec3+vec2", [](std::size_t iterations) {
+    for (std::size_t i{}; i < iterations; ++i) {
+      auto const value{static_cast<float>(i)};
+      glm::vec3 const position{value, value + 1.0f, value + 2.0f};
+      glm::vec3 const normal{0.0f, value, 1.0f};
+      glm::vec2 const texCoord{value, 0.5f};
+      doNotOptimize(abcg::hashCombine(position, normal, texCoord));
+    }
+  });
+
+  runner.add("hashCombine/string", [](std::size_t iterations) {
+    std::string const text{"assets/shaders/blinnphong.frag"};
+    for (std::size_t i{}; i < iterations; ++i) {
+      doNotOptimize(abcg::hashCombine(text, i));
+    }
+  });
+}
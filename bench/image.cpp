@@ -0,0 +1,63 @@
+#include "benchmark.hpp"
+
+#include <array>
+#include <memory>
+
+#include "abcgException.hpp"
+#include "abcgExternal.hpp"
+#include "abcgImage.hpp"
+
+namespace {
+struct SurfaceDeleter {
+  void operator()(SDL_Surface *surface) const { SDL_FreeSurface(surface); }
+};
+
+using SurfacePtr = std::unique_ptr<SDL_Surface, SurfaceDeleter>;
+
+[[nodiscard]] SurfacePtr createSurface(int size, Uint32 format) {
+  SurfacePtr surface{SDL_CreateRGBSurfaceWithFormat(
+      0, size, size, SDL_BITSPERPIXEL(format), format)};
+  if (!surface) {
+    throw abcg::SDLError("SDL_CreateRGBSurfaceWithFormat failed");
+  }
+  return surface;
+}
+} // namespace
+
+void registerImageBenchmarks(BenchmarkRunner &runner) {
+  struct Format {
+    Uint32 format;
+    char const *name;
+  };
+  std::array const formats{Format{SDL_PIXELFORMAT_RGB24, "RGB"},
+                           Format{SDL_PIXELFORMAT_RGBA32, "RGBA"}};
+  std::array const sizes{256, 1024, 4096};
+
+  // The benchmarks run outside abcg::Application::run, so there is no job
+  // system and the flips take their serial path
+
+  for (auto const &format : formats) {
+    for (auto const size : sizes) {
+      // Surfaces are shared by the benchmark bodies, which outlive this scope
+      std::shared_ptr<SDL_Surface> const surface{
+          createSurface(size, format.format)};
+
+      runner.add(fmt::format("flipVertically/serial/{}/{}x{}", format.name,
+                             size, size),
+                 [surface](std::size_t iterations) {
+                   for (std::size_t i{}; i < iterations; ++i) {
+                     abcg::flipVertically(*surface);
+                     doNotOptimize(surface->pixels);
+                   }
+                 });
+      runner.add(fmt::format("flipHorizontally/serial/{}/{}x{}", format.name,
+                             size, size),
+                 [surface](std::size_t iterations) {
+                   for (std::size_t i{}; i < iterations; ++i) {
+                     abcg::flipHorizontally(*surface);
+                     doNotOptimize(surface->pixels);
+                   }
+                 });
+    }
+  }
+}
@@ -0,0 +1,61 @@
+#include "benchmark.hpp"
+
+#include <fmt/core.h>
+
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <string>
+
+// Usage: abcg_bench [--filter <substring>] [--repeats <n>] [--output <file>]
+//
+// Results are written as JSON to stdout or to the given file. A summary is
+// printed to stderr.
+int main(int argc, char **argv) {
+  try {
+    std::string filter;
+    std::string output;
+    std::size_t repeats{9};
+
+    for (int i{1}; i < argc; ++i) {
+      std::string_view const arg{argv[i]};
+      if (i + 1 < argc && arg == "--filter") {
+        filter = argv[++i];
+      } else if (i + 1 < argc && arg == "--repeats") {
+        repeats = std::stoul(argv[++i]);
+      } else if (i + 1 < argc && arg == "--output") {
+        output = argv[++i];
+      } else {
+        fmt::print(stderr,
+                   "Usage: {} [--filter <substring>] [--repeats <n>] "
+                   "[--output <file>]\n",
+                   argv[0]);
+        return EXIT_FAILURE;
+      }
+    }
+
+    BenchmarkRunner runner;
+    registerImageBenchmarks(runner);
+    registerHashBenchmarks(runner);
+    registerModelBenchmarks(runner);
+    registerTrackBallBenchmarks(runner);
+#if defined(ABCG_BENCH_VULKAN)
+    registerShaderBenchmarks(runner);
+#endif
+
+    auto const json{toJSON(runner.run(filter, repeats))};
+
+    if (output.empty()) {
+      fmt::print("{}", json);
+    } else if (std::ofstream stream(output); stream) {
+      stream << json;
+    } else {
+      fmt::print(stderr, "Failed to write {}\n", output);
+      return EXIT_FAILURE;
+    }
+  } catch (std::exception const &exception) {
+    fmt::print(stderr, "{}\n", exception.what());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
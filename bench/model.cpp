@@ -0,0 +1,199 @@
+#include "benchmark.hpp"
+
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <numbers>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#include "abcgException.hpp"
+#include "abcgExternal.hpp"
+#include "abcgUtil.hpp"
+
+namespace {
+// Same vertex layout as the one used by the model viewer examples
+struct Vertex {
+  glm::vec3 position{};
+  glm::vec3 normal{};
+  glm::vec2 texCoord{};
+
+  friend bool operator==(Vertex const &, Vertex const &) = default;
+};
+
+struct Mesh {
+  std::vector<Vertex> vertices;
+  std::vector<unsigned> indices;
+};
+} // namespace
+
+// Explicit specialization of std::hash for Vertex
+template <> struct std::hash<Vertex> {
+  size_t operator()(Vertex const &vertex) const noexcept {
+    auto const h1{std::hash<glm::vec3>()(vertex.position)};
+    auto const h2{std::hash<glm::vec3>()(vertex.normal)};
+    auto const h3{std::hash<glm::vec2>()(vertex.texCoord)};
+    return abcg::hashCombine(h1, h2, h3);
+  }
+};
+
+namespace {
+// File removed on destruction, so that models written for the benchmarks do
+// not accumulate in the temporary directory
+class TemporaryFile {
+public:
+  explicit TemporaryFile(std::filesystem::path path)
+      : m_path{std::move(path)} {}
+  TemporaryFile(TemporaryFile const &) = delete;
+  TemporaryFile(TemporaryFile &&) = delete;
+  TemporaryFile &operator=(TemporaryFile const &) = delete;
+  TemporaryFile &operator=(TemporaryFile &&) = delete;
+  ~TemporaryFile() {
+    std::error_code errorCode;
+    std::filesystem::remove(m_path, errorCode);
+  }
+
+  [[nodiscard]] std::filesystem::path const &getPath() const noexcept {
+    return m_path;
+  }
+
+private:
+  std::filesystem::path m_path;
+};
+
+// Writes a UV sphere with shared positions, normals and texture coordinates,
+// so that every vertex is referenced by several faces as in typical OBJ files
+[[nodiscard]] std::shared_ptr<TemporaryFile const> writeSphere(int slices,
+                                                               int stacks) {
+  auto file{std::make_shared<TemporaryFile const>(
+      std::filesystem::temp_directory_path() /
+      fmt::format("abcg_bench_sphere_{}x{}.obj", slices, stacks))};
+  auto const &path{file->getPath()};
+
+  std::ofstream stream(path);
+  if (!stream) {
+    throw abcg::RuntimeError(fmt::format("Failed to create {}", path.string()));
+  }
+
+  for (auto const stack : iter::range(stacks + 1)) {
+    auto const phi{std::numbers::pi * stack / stacks};
+    for (auto const slice : iter::range(slices + 1)) {
+      auto const theta{2.0 * std::numbers::pi * slice / slices};
+      auto const x{std::sin(phi) * std::cos(theta)};
+      auto const y{std::cos(phi)};
+      auto const z{std::sin(phi) * std::sin(theta)};
+      stream << fmt::format("v {} {} {}\nvn {} {} {}\nvt {} {}\n", x, y, z, x,
+                            y, z, static_cast<double>(slice) / slices,
+                            static_cast<double>(stack) / stacks);
+    }
+  }
+
+  // OBJ indices start at 1
+  auto const index{[slices](int stack, int slice) {
+    return stack * (slices + 1) + slice + 1;
+  }};
+  for (auto const stack : iter::range(stacks)) {
+    for (auto const slice : iter::range(slices)) {
+      std::array const quad{index(stack, slice), index(stack + 1, slice),
+                            index(stack + 1, slice + 1),
+                            index(stack, slice + 1)};
+      stream << fmt::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\n", quad[0],
+                            quad[1], quad[2]);
+      stream << fmt::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\n", quad[0],
+                            quad[2], quad[3]);
+    }
+  }
+
+  return file;
+}
+
+[[nodiscard]] tinyobj::ObjReader parseObj(std::filesystem::path const &path) {
+  tinyobj::ObjReader reader;
+  if (!reader.ParseFromFile(path.string())) {
+    throw abcg::RuntimeError(
+        fmt::format("Failed to load model {} ({})", path.string(),
+                    reader.Error()));
+  }
+  return reader;
+}
+
+// Vertex deduplication, as done by Model::loadObj in the examples
+[[nodiscard]] Mesh deduplicate(tinyobj::ObjReader const &reader) {
+  auto const &attrib{reader.GetAttrib()};
+
+  Mesh mesh;
+  std::unordered_map<Vertex, unsigned> hash{};
+
+  for (auto const &shape : reader.GetShapes()) {
+    for (auto const &index : shape.mesh.indices) {
+      auto const startIndex{3 * index.vertex_index};
+      glm::vec3 const position{attrib.vertices.at(startIndex + 0),
+                               attrib.vertices.at(startIndex + 1),
+                               attrib.vertices.at(startIndex + 2)};
+
+      glm::vec3 normal{};
+      if (index.normal_index >= 0) {
+        auto const normalStartIndex{3 * index.normal_index};
+        normal = {attrib.normals.at(normalStartIndex + 0),
+                  attrib.normals.at(normalStartIndex + 1),
+                  attrib.normals.at(normalStartIndex + 2)};
+      }
+
+      glm::vec2 texCoord{};
+      if (index.texcoord_index >= 0) {
+        auto const texCoordsStartIndex{2 * index.texcoord_index};
+        texCoord = {attrib.texcoords.at(texCoordsStartIndex + 0),
+                    attrib.texcoords.at(texCoordsStartIndex + 1)};
+      }
+
+      Vertex const vertex{
+          .position = position, .normal = normal, .texCoord = texCoord};
+
+      if (!hash.contains(vertex)) {
+        hash[vertex] = gsl::narrow<unsigned>(mesh.vertices.size());
+        mesh.vertices.push_back(vertex);
+      }
+
+      mesh.indices.push_back(hash[vertex]);
+    }
+  }
+
+  return mesh;
+}
+} // namespace
+
+void registerModelBenchmarks(BenchmarkRunner &runner) {
+  struct Resolution {
+    int slices;
+    int stacks;
+  };
+  std::array const resolutions{Resolution{32, 16}, Resolution{256, 128}};
+
+  for (auto const &resolution : resolutions) {
+    // The file is removed once the benchmark bodies sharing it are destroyed
+    auto const file{writeSphere(resolution.slices, resolution.stacks)};
+    auto const suffix{
+        fmt::format("sphere {}x{}", resolution.slices, resolution.stacks)};
+
+    runner.add(fmt::format("loadObj/{}", suffix),
+               [file](std::size_t iterations) {
+                 for (std::size_t i{}; i < iterations; ++i) {
+                   doNotOptimize(
+                       deduplicate(parseObj(file->getPath())).indices.size());
+                 }
+               });
+
+    // Deduplication alone, on a model parsed in advance
+    auto const reader{std::make_shared<tinyobj::ObjReader>(
+        parseObj(file->getPath()))};
+    runner.add(fmt::format("deduplicateVertices/{}", suffix),
+               [reader](std::size_t iterations) {
+                 for (std::size_t i{}; i < iterations; ++i) {
+                   doNotOptimize(deduplicate(*reader).indices.size());
+                 }
+               });
+  }
+}
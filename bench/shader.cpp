@@ -0,0 +1,61 @@
+#include "benchmark.hpp"
+
+#include "abcgVulkanShader.hpp"
+
+namespace {
+constexpr char const *vertexShader{R"gl(#version 450
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+
+layout(binding = 0) uniform UniformBufferObject {
+  mat4 model;
+  mat4 view;
+  mat4 proj;
+} ubo;
+
+layout(location = 0) out vec3 fragNormal;
+
+void main() {
+  fragNormal = mat3(transpose(inverse(ubo.model))) * inNormal;
+  gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+}
+)gl"};
+
+constexpr char const *fragmentShader{R"gl(#version 450
+
+layout(location = 0) in vec3 fragNormal;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+  vec3 lightDir = normalize(vec3(1.0, 1.0, 1.0));
+  float diffuse = max(dot(normalize(fragNormal), lightDir), 0.0);
+  outColor = vec4(vec3(0.1 + 0.9 * diffuse), 1.0);
+}
+)gl"};
+} // namespace
+
+void registerShaderBenchmarks(BenchmarkRunner &runner) {
+  // Disable the SPIR-V cache so that the compilation is measured. glslang is
+  // initialized by the first iteration, which the runner discards as warm-up
+  abcg::setVulkanShaderCacheDirectory({});
+
+  runner.add("compileVulkanShader/vertex", [](std::size_t iterations) {
+    for (std::size_t i{}; i < iterations; ++i) {
+      doNotOptimize(abcg::compileVulkanShader(
+                        {.source = vertexShader,
+                         .stage = abcg::ShaderStage::Vertex})
+                        .size());
+    }
+  });
+
+  runner.add("compileVulkanShader/fragment", [](std::size_t iterations) {
+    for (std::size_t i{}; i < iterations; ++i) {
+      doNotOptimize(abcg::compileVulkanShader(
+                        {.source = fragmentShader,
+                         .stage = abcg::ShaderStage::Fragment})
+                        .size());
+    }
+  });
+}
@@ -0,0 +1,44 @@
+#include "benchmark.hpp"
+
+#include <cmath>
+#include <numbers>
+
+#include "abcgTrackball.hpp"
+
+namespace {
+constexpr glm::ivec2 viewportSize{1280, 720};
+
+// Position on a circle around the center of the viewport
+[[nodiscard]] glm::ivec2 circlePosition(std::size_t step) {
+  auto const angle{static_cast<float>(step % 360) * std::numbers::pi_v<float> /
+                   180.0f};
+  auto const radius{static_cast<float>(viewportSize.y) * 0.4f};
+  return viewportSize / 2 + glm::ivec2{radius * std::cos(angle),
+                                       radius * std::sin(angle)};
+}
+} // namespace
+
+void registerTrackBallBenchmarks(BenchmarkRunner &runner) {
+  runner.add("TrackBall::mouseMove", [](std::size_t iterations) {
+    abcg::TrackBall trackBall;
+    trackBall.resizeViewport(viewportSize);
+    trackBall.mousePress(circlePosition(0));
+    for (std::size_t i{}; i < iterations; ++i) {
+      trackBall.mouseMove(circlePosition(i + 1));
+    }
+    doNotOptimize(trackBall.getRotation());
+  });
+
+  runner.add("TrackBall::getRotation", [](std::size_t iterations) {
+    abcg::TrackBall trackBall;
+    trackBall.resizeViewport(viewportSize);
+    trackBall.mousePress(circlePosition(0));
+    trackBall.mouseMove(circlePosition(10));
+    // Release to let the trackball spin, so that the rotation is recomputed on
+    // every call
+    trackBall.mouseRelease(circlePosition(20));
+    for (std::size_t i{}; i < iterations; ++i) {
+      doNotOptimize(trackBall.getRotation());
+    }
+  });
+}
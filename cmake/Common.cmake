@@ -12,6 +12,13 @@ if(NOT ${CMAKE_SYSTEM_NAME} MATCHES "Emscripten")
   # Conan
   option(ENABLE_CONAN "Use Conan Package Manager" OFF)
 
+  # OpenGL error checking with KHR_debug in debug builds
+  option(ENABLE_GL_DEBUG_CALLBACK
+         "Check OpenGL errors with a KHR_debug callback by default" OFF)
+
+  # Microbenchmarks
+  option(ENABLE_BENCHMARKS "Build the abcg_bench microbenchmarks" OFF)
+
   # mold
   if(NOT MSVC)
     option(ENABLE_MOLD "Enable mold (Modern Linker)" ON)
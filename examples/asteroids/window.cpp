@@ -97,8 +97,8 @@ void Window::restart() {
   m_bullets.create(m_objectsProgram);
 }
 
-void Window::onUpdate() {
-  auto const deltaTime{gsl::narrow_cast<float>(getDeltaTime())};
+void Window::onFixedUpdate(double const fixedDeltaTime) {
+  auto const deltaTime{gsl::narrow_cast<float>(fixedDeltaTime)};
 
   // Wait 5 seconds before restarting
   if (m_gameData.m_state != State::Playing &&
@@ -12,7 +12,7 @@ class Window : public abcg::OpenGLWindow {
 protected:
   void onEvent(SDL_Event const &event) override;
   void onCreate() override;
-  void onUpdate() override;
+  void onFixedUpdate(double deltaTime) override;
   void onPaint() override;
   void onPaintUI() override;
   void onResize(glm::ivec2 const &size) override;
@@ -142,15 +142,14 @@ void Window::destroyBuffers() { m_vertexBuffer.destroy(); }
 void Window::createShaders() {
   auto const assetsPath{abcg::Application::getAssetsPath()};
 
-  // Crete vertex shader
-  m_vertexShader.create(getDevice(),
-                        {.source = assetsPath + "UnlitVertexColor.vert",
-                         .stage = abcg::ShaderStage::Vertex});
-
-  // Create fragment shader
-  m_fragmentShader.create(getDevice(),
-                          {.source = assetsPath + "UnlitVertexColor.frag",
-                           .stage = abcg::ShaderStage::Fragment});
+  // Create vertex and fragment shaders, compiled concurrently
+  auto shaders{abcg::VulkanShader::createMany(
+      getDevice(), {{.source = assetsPath + "UnlitVertexColor.vert",
+                     .stage = abcg::ShaderStage::Vertex},
+                    {.source = assetsPath + "UnlitVertexColor.frag",
+                     .stage = abcg::ShaderStage::Fragment}})};
+  m_vertexShader = std::move(shaders.at(0));
+  m_fragmentShader = std::move(shaders.at(1));
 }
 
 void Window::destroyShaders() {
@@ -9,14 +9,14 @@ void Window::onCreate() {
   abcg::glClearColor(0, 0, 0, 1);
   abcg::glEnable(GL_DEPTH_TEST);
 
-  m_program =
+  m_program = abcg::OpenGLProgram{
       abcg::createOpenGLProgram({{.source = assetsPath + "depth.vert",
                                   .stage = abcg::ShaderStage::Vertex},
                                  {.source = assetsPath + "depth.frag",
-                                  .stage = abcg::ShaderStage::Fragment}});
+                                  .stage = abcg::ShaderStage::Fragment}})};
 
   m_model.loadObj(assetsPath + "box.obj");
-  m_model.setupVAO(m_program);
+  m_model.setupVAO(m_program.getID());
 
   // Camera at (0,0,0) and looking towards the negative z
   glm::vec3 const eye{0.0f, 0.0f, 0.0f};
@@ -66,19 +66,15 @@ void Window::onPaint() {
 
   abcg::glViewport(0, 0, m_viewportSize.x, m_viewportSize.y);
 
-  abcg::glUseProgram(m_program);
+  m_program.use();
 
-  // Get location of uniform variables
-  auto const viewMatrixLoc{abcg::glGetUniformLocation(m_program, "viewMatrix")};
-  auto const projMatrixLoc{abcg::glGetUniformLocation(m_program, "projMatrix")};
-  auto const modelMatrixLoc{
-      abcg::glGetUniformLocation(m_program, "modelMatrix")};
-  auto const colorLoc{abcg::glGetUniformLocation(m_program, "color")};
+  // Get handle of the uniform variable that changes for each star
+  auto const modelMatrixHandle{m_program.getUniformHandle("modelMatrix")};
 
   // Set uniform variables that have the same value for every model
-  abcg::glUniformMatrix4fv(viewMatrixLoc, 1, GL_FALSE, &m_viewMatrix[0][0]);
-  abcg::glUniformMatrix4fv(projMatrixLoc, 1, GL_FALSE, &m_projMatrix[0][0]);
-  abcg::glUniform4f(colorLoc, 1.0f, 1.0f, 1.0f, 1.0f); // White
+  m_program.setUniform("viewMatrix", m_viewMatrix);
+  m_program.setUniform("projMatrix", m_projMatrix);
+  m_program.setUniform("color", glm::vec4{1.0f}); // White
 
   // Render each star
   for (auto &star : m_stars) {
@@ -89,7 +85,7 @@ void Window::onPaint() {
     modelMatrix = glm::rotate(modelMatrix, m_angle, star.m_rotationAxis);
 
     // Set uniform variable
-    abcg::glUniformMatrix4fv(modelMatrixLoc, 1, GL_FALSE, &modelMatrix[0][0]);
+    m_program.setUniform(modelMatrixHandle, modelMatrix);
 
     m_model.render();
   }
@@ -147,5 +143,5 @@ void Window::onResize(glm::ivec2 const &size) { m_viewportSize = size; }
 
 void Window::onDestroy() {
   m_model.destroy();
-  abcg::glDeleteProgram(m_program);
+  m_program.destroy();
 }
\ No newline at end of file
@@ -35,7 +35,7 @@ private:
   glm::mat4 m_projMatrix{1.0f};
   float m_FOV{30.0f};
 
-  GLuint m_program{};
+  abcg::OpenGLProgram m_program;
 
   void randomizeStar(Star &star);
 };
@@ -3,9 +3,9 @@
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
 
+#include "frameuniforms.glsl"
+
 uniform mat4 modelMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projMatrix;
 uniform mat3 normalMatrix;
 
 out vec3 fragP;
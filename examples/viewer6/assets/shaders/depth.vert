@@ -2,9 +2,9 @@
 
 layout(location = 0) in vec3 inPosition;
 
+#include "frameuniforms.glsl"
+
 uniform mat4 modelMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projMatrix;
 
 out vec4 fragColor;
 
@@ -0,0 +1,8 @@
+// Uniform variables shared by all programs (see abcg::FrameUniforms)
+layout(std140) uniform FrameUniforms {
+  highp mat4 viewMatrix;
+  highp mat4 projMatrix;
+  highp vec4 lightDirWorldSpace;
+  highp vec4 Ia, Id, Is;
+  highp float time;
+};
@@ -3,15 +3,11 @@
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
 
+#include "frameuniforms.glsl"
+
 uniform mat4 modelMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projMatrix;
 uniform mat3 normalMatrix;
 
-// Light properties
-uniform vec4 lightDirWorldSpace;
-uniform vec4 Ia, Id, Is;
-
 // Material properties
 uniform vec4 Ka, Kd, Ks;
 uniform float shininess;
@@ -13,8 +13,8 @@ in vec3 fragVEye;
 
 uniform mat3 normalMatrix;
 
-// Light properties
-uniform vec4 Ia, Id, Is;
+// Frame and light properties
+#include "frameuniforms.glsl"
 
 // Material properties
 uniform vec4 Ka, Kd, Ks;
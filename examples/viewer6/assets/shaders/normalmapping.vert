@@ -5,11 +5,9 @@ layout(location = 1) in vec3 inNormal;
 layout(location = 2) in vec2 inTexCoord;
 layout(location = 3) in vec4 inTangent;
 
-uniform mat4 modelMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projMatrix;
+#include "frameuniforms.glsl"
 
-uniform vec4 lightDirWorldSpace;
+uniform mat4 modelMatrix;
 
 out vec2 fragTexCoord;
 out vec3 fragPObj;
@@ -6,8 +6,8 @@ in vec3 fragN;
 in vec3 fragL;
 in vec3 fragV;
 
-// Light properties
-uniform vec4 Ia, Id, Is;
+// Frame and light properties
+#include "frameuniforms.glsl"
 
 // Material properties
 uniform vec4 Ka, Kd, Ks;
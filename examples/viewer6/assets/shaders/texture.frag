@@ -9,8 +9,8 @@ in vec2 fragTexCoord;
 in vec3 fragPObj;
 in vec3 fragNObj;
 
-// Light properties
-uniform vec4 Ia, Id, Is;
+// Frame and light properties
+#include "frameuniforms.glsl"
 
 // Material properties
 uniform vec4 Ka, Kd, Ks;
@@ -4,13 +4,11 @@ layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
 layout(location = 2) in vec2 inTexCoord;
 
+#include "frameuniforms.glsl"
+
 uniform mat4 modelMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projMatrix;
 uniform mat3 normalMatrix;
 
-uniform vec4 lightDirWorldSpace;
-
 out vec3 fragV;
 out vec3 fragL;
 out vec3 fragN;
@@ -5,7 +5,7 @@ int main(int argc, char **argv) {
     abcg::Application app(argc, argv);
 
     Window window;
-    window.setOpenGLSettings({.samples = 4});
+    window.setOpenGLSettings({.samples = 4, .programBinaryCache = true});
     window.setWindowSettings({
         .width = 600,
         .height = 600,
@@ -39,13 +39,22 @@ void Window::onCreate() {
   abcg::glEnable(GL_DEPTH_TEST);
 
   // Create programs
+  std::vector<std::vector<abcg::ShaderSource>> programSources;
   for (auto const &name : m_shaderNames) {
     auto const path{assetsPath + "shaders/" + name};
-    auto const program{abcg::createOpenGLProgram(
+    programSources.push_back(
         {{.source = path + ".vert", .stage = abcg::ShaderStage::Vertex},
-         {.source = path + ".frag", .stage = abcg::ShaderStage::Fragment}})};
-    m_programs.push_back(program);
+         {.source = path + ".frag", .stage = abcg::ShaderStage::Fragment}});
   }
+  auto const programs{abcg::createOpenGLPrograms(programSources)};
+  for (auto const index : iter::range(programs.size())) {
+    // Rebuild the program when its shader files are edited
+    auto &program{m_programs.emplace_back(programs.at(index))};
+    program.enableHotReload(programSources.at(index));
+  }
+
+  // Create buffer of uniform variables shared by all programs
+  m_frameUniforms.create();
 
   // Load default model
   loadModel(assetsPath + "bunny.obj");
@@ -66,7 +75,7 @@ void Window::loadModel(std::string_view path) {
   m_model.loadNormalTexture(assetsPath + "maps/pattern_normal.png");
   m_model.loadCubeTexture(assetsPath + "maps/cube/");
   m_model.loadObj(path);
-  m_model.setupVAO(m_programs.at(m_currentProgramIndex));
+  m_model.setupVAO(m_programs.at(m_currentProgramIndex).getID());
   m_trianglesToDraw = m_model.getNumTriangles();
 
   // Use material properties from the loaded model
@@ -77,63 +86,53 @@ void Window::loadModel(std::string_view path) {
 }
 
 void Window::onPaint() {
+  // Hot reload makes OpenGL calls, so it must run on the render thread
+  auto const &currentProgram{m_programs.at(m_currentProgramIndex)};
+  for (auto &program : m_programs) {
+    if (program.updateHotReload() && &program == &currentProgram) {
+      m_model.setupVAO(program.getID());
+    }
+  }
+
   abcg::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
   abcg::glViewport(0, 0, m_viewportSize.x, m_viewportSize.y);
 
+  // Update uniform variables shared by all programs
+  m_frameUniforms.update(
+      {.viewMatrix = m_viewMatrix,
+       .projMatrix = m_projMatrix,
+       .lightDirWorldSpace = m_trackBallLight.getRotation() * m_lightDir,
+       .Ia = m_Ia,
+       .Id = m_Id,
+       .Is = m_Is,
+       .time = static_cast<float>(getElapsedTime()),
+       .padding = {}});
+
   // Use currently selected program
-  auto const program{m_programs.at(m_currentProgramIndex)};
-  abcg::glUseProgram(program);
-
-  // Get location of uniform variables
-  auto const viewMatrixLoc{abcg::glGetUniformLocation(program, "viewMatrix")};
-  auto const projMatrixLoc{abcg::glGetUniformLocation(program, "projMatrix")};
-  auto const modelMatrixLoc{abcg::glGetUniformLocation(program, "modelMatrix")};
-  auto const normalMatrixLoc{
-      abcg::glGetUniformLocation(program, "normalMatrix")};
-  auto const lightDirLoc{
-      abcg::glGetUniformLocation(program, "lightDirWorldSpace")};
-  auto const shininessLoc{abcg::glGetUniformLocation(program, "shininess")};
-  auto const IaLoc{abcg::glGetUniformLocation(program, "Ia")};
-  auto const IdLoc{abcg::glGetUniformLocation(program, "Id")};
-  auto const IsLoc{abcg::glGetUniformLocation(program, "Is")};
-  auto const KaLoc{abcg::glGetUniformLocation(program, "Ka")};
-  auto const KdLoc{abcg::glGetUniformLocation(program, "Kd")};
-  auto const KsLoc{abcg::glGetUniformLocation(program, "Ks")};
-  auto const diffuseTexLoc{abcg::glGetUniformLocation(program, "diffuseTex")};
-  auto const normalTexLoc{abcg::glGetUniformLocation(program, "normalTex")};
-  auto const cubeTexLoc{abcg::glGetUniformLocation(program, "cubeTex")};
-  auto const mappingModeLoc{abcg::glGetUniformLocation(program, "mappingMode")};
-  auto const texMatrixLoc{abcg::glGetUniformLocation(program, "texMatrix")};
+  auto &program{m_programs.at(m_currentProgramIndex)};
+  program.use();
 
   // Set uniform variables that have the same value for every model
-  abcg::glUniformMatrix4fv(viewMatrixLoc, 1, GL_FALSE, &m_viewMatrix[0][0]);
-  abcg::glUniformMatrix4fv(projMatrixLoc, 1, GL_FALSE, &m_projMatrix[0][0]);
-  abcg::glUniform1i(diffuseTexLoc, 0);
-  abcg::glUniform1i(normalTexLoc, 1);
-  abcg::glUniform1i(cubeTexLoc, 2);
-  abcg::glUniform1i(mappingModeLoc, m_mappingMode);
+  program.setUniform("diffuseTex", 0);
+  program.setUniform("normalTex", 1);
+  program.setUniform("cubeTex", 2);
+  program.setUniform("mappingMode", m_mappingMode);
 
   glm::mat3 const texMatrix{m_trackBallLight.getRotation()};
-  abcg::glUniformMatrix3fv(texMatrixLoc, 1, GL_TRUE, &texMatrix[0][0]);
-
-  auto const lightDirRotated{m_trackBallLight.getRotation() * m_lightDir};
-  abcg::glUniform4fv(lightDirLoc, 1, &lightDirRotated.x);
-  abcg::glUniform4fv(IaLoc, 1, &m_Ia.x);
-  abcg::glUniform4fv(IdLoc, 1, &m_Id.x);
-  abcg::glUniform4fv(IsLoc, 1, &m_Is.x);
+  program.setUniform("texMatrix", glm::transpose(texMatrix));
 
   // Set uniform variables for the current model
-  abcg::glUniformMatrix4fv(modelMatrixLoc, 1, GL_FALSE, &m_modelMatrix[0][0]);
+  program.setUniform("modelMatrix", m_modelMatrix);
 
   auto const modelViewMatrix{glm::mat3(m_viewMatrix * m_modelMatrix)};
   auto const normalMatrix{glm::inverseTranspose(modelViewMatrix)};
-  abcg::glUniformMatrix3fv(normalMatrixLoc, 1, GL_FALSE, &normalMatrix[0][0]);
+  program.setUniform("normalMatrix", normalMatrix);
 
-  abcg::glUniform4fv(KaLoc, 1, &m_Ka.x);
-  abcg::glUniform4fv(KdLoc, 1, &m_Kd.x);
-  abcg::glUniform4fv(KsLoc, 1, &m_Ks.x);
-  abcg::glUniform1f(shininessLoc, m_shininess);
+  program.setUniform("Ka", m_Ka);
+  program.setUniform("Kd", m_Kd);
+  program.setUniform("Ks", m_Ks);
+  program.setUniform("shininess", m_shininess);
 
   m_model.render(m_trianglesToDraw);
 
@@ -310,7 +309,7 @@ void Window::onPaintUI() {
       // Set up VAO if shader program has changed
       if (gsl::narrow<int>(currentIndex) != m_currentProgramIndex) {
         m_currentProgramIndex = gsl::narrow<int>(currentIndex);
-        m_model.setupVAO(m_programs.at(m_currentProgramIndex));
+        m_model.setupVAO(m_programs.at(m_currentProgramIndex).getID());
       }
     }
 
@@ -415,9 +414,10 @@ void Window::onResize(glm::ivec2 const &size) {
 
 void Window::onDestroy() {
   m_model.destroy();
-  for (auto const &program : m_programs) {
-    abcg::glDeleteProgram(program);
+  for (auto &program : m_programs) {
+    program.destroy();
   }
+  m_frameUniforms.destroy();
 }
 
 void Window::createSkybox() {
@@ -425,9 +425,9 @@ void Window::createSkybox() {
 
   // Create skybox program
   auto const path{assetsPath + "shaders/" + m_skyShaderName};
-  m_skyProgram = abcg::createOpenGLProgram(
+  m_skyProgram = abcg::OpenGLProgram{abcg::createOpenGLProgram(
       {{.source = path + ".vert", .stage = abcg::ShaderStage::Vertex},
-       {.source = path + ".frag", .stage = abcg::ShaderStage::Fragment}});
+       {.source = path + ".frag", .stage = abcg::ShaderStage::Fragment}})};
 
   // Generate VBO
   abcg::glGenBuffers(1, &m_skyVBO);
@@ -437,8 +437,7 @@ void Window::createSkybox() {
   abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
 
   // Get location of attributes in the program
-  auto const positionAttribute{
-      abcg::glGetAttribLocation(m_skyProgram, "inPosition")};
+  auto const positionAttribute{m_skyProgram.getAttributeLocation("inPosition")};
 
   // Create VAO
   abcg::glGenVertexArrays(1, &m_skyVAO);
@@ -457,18 +456,11 @@ void Window::createSkybox() {
 }
 
 void Window::renderSkybox() {
-  abcg::glUseProgram(m_skyProgram);
-
-  auto const viewMatrixLoc{
-      abcg::glGetUniformLocation(m_skyProgram, "viewMatrix")};
-  auto const projMatrixLoc{
-      abcg::glGetUniformLocation(m_skyProgram, "projMatrix")};
-  auto const skyTexLoc{abcg::glGetUniformLocation(m_skyProgram, "skyTex")};
+  m_skyProgram.use();
 
-  auto const viewMatrix{m_trackBallLight.getRotation()};
-  abcg::glUniformMatrix4fv(viewMatrixLoc, 1, GL_FALSE, &viewMatrix[0][0]);
-  abcg::glUniformMatrix4fv(projMatrixLoc, 1, GL_FALSE, &m_projMatrix[0][0]);
-  abcg::glUniform1i(skyTexLoc, 0);
+  m_skyProgram.setUniform("viewMatrix", m_trackBallLight.getRotation());
+  m_skyProgram.setUniform("projMatrix", m_projMatrix);
+  m_skyProgram.setUniform("skyTex", 0);
 
   abcg::glBindVertexArray(m_skyVAO);
 
@@ -485,8 +477,8 @@ void Window::renderSkybox() {
   abcg::glUseProgram(0);
 }
 
-void Window::destroySkybox() const {
-  abcg::glDeleteProgram(m_skyProgram);
+void Window::destroySkybox() {
+  m_skyProgram.destroy();
   abcg::glDeleteBuffers(1, &m_skyVBO);
   abcg::glDeleteVertexArrays(1, &m_skyVAO);
 }
\ No newline at end of file
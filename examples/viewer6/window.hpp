@@ -33,7 +33,8 @@ private:
   std::vector<char const *> m_shaderNames{
       "cubereflect", "cuberefract", "normalmapping", "texture", "blinnphong",
       "phong",       "gouraud",     "normal",        "depth"};
-  std::vector<GLuint> m_programs;
+  std::vector<abcg::OpenGLProgram> m_programs;
+  abcg::OpenGLFrameUniforms m_frameUniforms;
   int m_currentProgramIndex{};
 
   // Mapping mode
@@ -54,7 +55,7 @@ private:
   std::string const m_skyShaderName{"skybox"};
   GLuint m_skyVAO{};
   GLuint m_skyVBO{};
-  GLuint m_skyProgram{};
+  abcg::OpenGLProgram m_skyProgram;
 
   // clang-format off
   std::array<glm::vec3, 36> const m_skyPositions{{
@@ -80,7 +81,7 @@ private:
 
   void createSkybox();
   void renderSkybox();
-  void destroySkybox() const;
+  void destroySkybox();
   void loadModel(std::string_view path);
 };
 